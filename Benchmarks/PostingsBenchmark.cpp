@@ -0,0 +1,235 @@
+#include "Index/BitPacking.h"
+#include "Index/InvertedIndex.h"
+#include "Index/PostingList.h"
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+
+
+namespace
+{
+    double Since(std::chrono::steady_clock::time_point p_Start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - p_Start).count();
+    }
+
+    // Lawsuit records as SCON returns them: a few hundred words of headnote and decision drawn from
+    // a Zipf distribution over legal vocabulary, so common terms get dense lists and rare ones short lists
+    struct SyntheticCorpus
+    {
+        std::vector<std::string> Cases, Rapporteurs, Dates, Headnotes, Decisions;
+
+        SCPY::LawsuitView operator[](size_t p_Index) const
+        {
+            SCPY::LawsuitView view;
+            view.Case = Cases[p_Index];
+            view.Rapporteur = Rapporteurs[p_Index];
+            view.JudgmentDate = Dates[p_Index];
+            view.PubDate = Dates[p_Index];
+            view.Headnote = Headnotes[p_Index];
+            view.Decision = Decisions[p_Index];
+            return view;
+        }
+    };
+
+    SyntheticCorpus MakeCorpus(size_t p_Count)
+    {
+        static const char* s_Words[] = {
+            "recurso", "especial", "agravo", "interno", "processual", "civil", "acórdão", "dano", "moral", "material",
+            "indenização", "responsabilidade", "tributário", "contrato", "consumidor", "prescrição", "honorários",
+            "advocatícios", "execução", "fiscal", "embargos", "declaração", "omissão", "súmula", "reexame", "provas",
+            "impossibilidade", "jurisprudência", "tribunal", "origem", "competência", "penal", "habeas", "corpus",
+            "prisão", "preventiva", "fundamentação", "idônea", "ordem", "denegada", "provimento", "negado", "parcial",
+            "administrativo", "servidor", "público", "previdenciário", "benefício", "aposentadoria", "pensão",
+            "família", "alimentos", "guarda", "compartilhada", "plano", "saúde", "cobertura", "abusividade", "cláusula",
+            "bancário", "juros", "remuneratórios", "capitalização", "mensal", "correção", "monetária", "termo", "inicial",
+            "ambiental", "poluição", "desapropriação", "indireta", "usucapião", "extraordinário", "possessória",
+        };
+        static const char* s_Classes[] = { "REsp", "AgInt no AREsp", "AgRg no REsp", "HC", "RHC", "EDcl no REsp", "CC" };
+        static const char* s_States[] = { "SP", "RJ", "MG", "RS", "PR", "SC", "BA", "PE", "DF", "GO" };
+        static const char* s_Ministers[] = { "Ministro HERMAN BENJAMIN", "Ministra NANCY ANDRIGHI", "Ministro LUIS FELIPE SALOMÃO",
+                                             "Ministra ASSUSETE MAGALHÃES", "Ministro ROGERIO SCHIETTI CRUZ" };
+
+        std::mt19937 rng(42);
+        std::vector<double> weights(std::size(s_Words));
+        for (size_t i = 0; i < weights.size(); i++)
+            weights[i] = 1.0 / double(i + 1);
+        std::discrete_distribution<size_t> zipf(weights.begin(), weights.end());
+
+        auto text = [&](size_t p_Words)
+        {
+            std::string result;
+            for (size_t i = 0; i < p_Words; i++)
+            {
+                // now and then a number, like the cited articles and laws
+                if (rng() % 40 == 0)
+                    result += "art. " + std::to_string(rng() % 1000) + ' ';
+                result += s_Words[zipf(rng)];
+                result += rng() % 12 == 0 ? ". " : " ";
+            }
+            return result;
+        };
+
+        SyntheticCorpus corpus;
+        for (size_t i = 0; i < p_Count; i++)
+        {
+            char date[16];
+            std::snprintf(date, sizeof(date), "%02u/%02u/%u", unsigned(rng() % 28 + 1), unsigned(rng() % 12 + 1), unsigned(2000 + rng() % 25));
+
+            corpus.Cases.push_back(std::string(s_Classes[rng() % std::size(s_Classes)]) + ' ' + std::to_string(1000000 + rng() % 1500000) + '/' + s_States[rng() % std::size(s_States)]);
+            corpus.Rapporteurs.push_back(s_Ministers[rng() % std::size(s_Ministers)]);
+            corpus.Dates.push_back(date);
+            corpus.Headnotes.push_back(text(80 + rng() % 120));
+            corpus.Decisions.push_back(text(20 + rng() % 40));
+        }
+
+        return corpus;
+    }
+
+    // Every p_Stride-th document on average, with the positions a short field would give
+    SCPY::PostingList MakePostings(std::vector<uint32_t>& p_Docs, uint32_t p_DocCount, uint32_t p_Stride, uint32_t p_Seed)
+    {
+        std::mt19937 rng(p_Seed);
+        SCPY::PostingList list;
+        const uint32_t positions[] = { 3, 17, 40 };
+        for (uint32_t doc = rng() % p_Stride; doc < p_DocCount; doc += 1 + rng() % (2 * p_Stride - 1))
+        {
+            list.Add(doc, positions, 1 + rng() % 3);
+            p_Docs.push_back(doc);
+        }
+        list.ShrinkToFit();
+        return list;
+    }
+
+    void RunUnpack(uint8_t p_Bits, int p_Rounds)
+    {
+        std::mt19937 rng(p_Bits);
+        const size_t blocks = 1024;
+
+        std::vector<uint32_t> values(SCPY::s_PackedBlockSize);
+        std::vector<uint8_t> packed(blocks * SCPY::GetPackedByteSize(p_Bits));
+        for (size_t block = 0; block < blocks; block++)
+        {
+            for (auto& value : values)
+                value = p_Bits == 32 ? (uint32_t)rng() : (uint32_t)rng() & ((1u << p_Bits) - 1);
+            SCPY::PackBlock(values.data(), p_Bits, packed.data() + block * SCPY::GetPackedByteSize(p_Bits));
+        }
+
+        auto run = [&](auto&& p_Unpack, auto&& p_DecodeGaps)
+        {
+            uint64_t checksum = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (int round = 0; round < p_Rounds; round++)
+            {
+                for (size_t block = 0; block < blocks; block++)
+                {
+                    p_Unpack(packed.data() + block * SCPY::GetPackedByteSize(p_Bits), p_Bits, values.data());
+                    p_DecodeGaps(values.data(), values.size(), 0);
+                    checksum += values.back();
+                }
+            }
+            double seconds = Since(start);
+            return std::make_pair(double(p_Rounds) * blocks * SCPY::s_PackedBlockSize / seconds / 1e6, checksum);
+        };
+
+        auto scalar = run(SCPY::UnpackBlockScalar, SCPY::DecodeGapsScalar);
+        auto dispatched = run(SCPY::UnpackBlock, SCPY::DecodeGaps);
+
+        std::printf("%2u bits   %8.0f  %8.0f Mdocs/s  (checksum %s)\n", unsigned(p_Bits), scalar.first, dispatched.first,
+                    scalar.second == dispatched.second ? "ok" : "MISMATCH");
+    }
+
+    void RunIntersection(uint32_t p_DocCount, uint32_t p_RareStride, uint32_t p_CommonStride, int p_Rounds)
+    {
+        std::vector<uint32_t> rareDocs, commonDocs, result;
+        SCPY::PostingList rare = MakePostings(rareDocs, p_DocCount, p_RareStride, 1);
+        SCPY::PostingList common = MakePostings(commonDocs, p_DocCount, p_CommonStride, 2);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < p_Rounds; round++)
+        {
+            result.clear();
+            std::set_intersection(rareDocs.begin(), rareDocs.end(), commonDocs.begin(), commonDocs.end(), std::back_inserter(result));
+        }
+        double linear = Since(start) / p_Rounds;
+        size_t expected = result.size();
+
+        start = std::chrono::steady_clock::now();
+        for (int round = 0; round < p_Rounds; round++)
+        {
+            result.clear();
+            SCPY::PostingList::Cursor cursor(common);
+            for (uint32_t doc : rareDocs)
+            {
+                if (!cursor.SkipTo(doc))
+                    break;
+                if (cursor.GetDoc() == doc)
+                    result.push_back(doc);
+            }
+        }
+        double skipping = Since(start) / p_Rounds;
+
+        size_t raw = (rareDocs.size() + commonDocs.size()) * sizeof(uint32_t);
+        std::printf("%7zu x %8zu docs   set_intersection %8.1f us   SkipTo %8.1f us   %zu hits%s\n", rareDocs.size(), commonDocs.size(),
+                    linear * 1e6, skipping * 1e6, expected, result.size() == expected ? "" : "  MISMATCH");
+        std::printf("%24s %.2f MB packed with frequencies and positions, %.2f MB as plain uint32 documents\n", "",
+                    (rare.GetByteSize() + common.GetByteSize()) / (1024.0 * 1024.0), raw / (1024.0 * 1024.0));
+    }
+
+    void RunQuery(const SCPY::InvertedIndex& p_Index, const char* p_Query, int p_Rounds)
+    {
+        size_t hits = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < p_Rounds; round++)
+            hits = p_Index.Search(p_Query, 20).size();
+
+        std::printf("%-40s %8.2f ms  (%zu hits)\n", p_Query, Since(start) / p_Rounds * 1e3, hits);
+    }
+
+} // namespace
+
+int main()
+{
+    std::printf("Dispatched kernel: %s\n\n", SCPY::GetPackingKernelName());
+
+    std::printf("Unpack + gap decode, scalar vs dispatched\n");
+    for (uint8_t bits : { 1, 3, 5, 8, 12, 17, 32 })
+        RunUnpack(bits, 200);
+
+    std::printf("\nAND of a rare and a common list\n");
+    RunIntersection(4000000, 2000, 2, 20);
+    RunIntersection(4000000, 100, 3, 20);
+    RunIntersection(4000000, 5, 4, 20);
+
+    const size_t lawsuits = 100000;
+    SyntheticCorpus corpus = MakeCorpus(lawsuits);
+
+    SCPY::InvertedIndex index;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < lawsuits; i++)
+        index.Add(corpus[i]);
+    double build = Since(start);
+
+    size_t text = 0;
+    for (size_t i = 0; i < lawsuits; i++)
+        text += corpus.Cases[i].size() + corpus.Headnotes[i].size() + corpus.Decisions[i].size();
+
+    std::printf("\nIndexed %zu lawsuits (%.1f MB of text) in %.2f s: %zu terms, %.1f MB\n", lawsuits, text / (1024.0 * 1024.0), build,
+                index.GetTermCount(), index.GetByteSize() / (1024.0 * 1024.0));
+
+    RunQuery(index, "recurso especial", 20);
+    RunQuery(index, "usucapião e recurso", 20);
+    RunQuery(index, "possessória e extraordinário e agravo", 20);
+    RunQuery(index, "\"dano moral\"", 20);
+    RunQuery(index, "\"correção monetária\" e não juros", 20);
+
+    return 0;
+}
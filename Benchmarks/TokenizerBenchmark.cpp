@@ -0,0 +1,132 @@
+#include "Index/Tokenizer.h"
+#include "Index/Stemmer.h"
+
+// std
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+
+
+namespace
+{
+    // Headnote-like text: accented legal vocabulary drawn from a Zipf distribution, with the punctuation,
+    // citations, case numbers and line breaks SCON pages carry
+    std::vector<std::string> MakeFields(size_t p_Count, size_t p_Size)
+    {
+        static const char* s_Words[] = {
+            "de", "a", "o", "que", "e", "do", "da", "em", "recurso", "especial", "não", "para", "com", "acórdão", "agravo",
+            "interno", "processual", "civil", "dano", "moral", "indenização", "responsabilidade", "tributário", "súmula",
+            "reexame", "provas", "impossibilidade", "jurisprudência", "tribunal", "origem", "competência", "habeas", "corpus",
+            "prisão", "preventiva", "fundamentação", "idônea", "provimento", "negado", "administrativo", "servidor", "público",
+            "previdenciário", "benefício", "aposentadoria", "pensão", "alimentos", "cláusula", "juros", "correção", "monetária",
+            "desapropriação", "usucapião", "extraordinário", "possessória", "embargos", "declaração", "omissão", "honorários",
+            "advocatícios", "execução", "fiscal", "prescrição", "decisões", "razões", "contratuais", "consumidores",
+        };
+
+        std::mt19937 rng(42);
+        std::vector<double> weights(std::size(s_Words));
+        for (size_t i = 0; i < weights.size(); i++)
+            weights[i] = 1.0 / double(i + 1);
+        std::discrete_distribution<size_t> zipf(weights.begin(), weights.end());
+
+        std::vector<std::string> fields(p_Count);
+        for (auto& field : fields)
+        {
+            while (field.size() < p_Size)
+            {
+                const char* word = s_Words[zipf(rng)];
+                switch (rng() % 32)
+                {
+                    case 0:  field += "art. " + std::to_string(rng() % 1000) + ", § 2º, "; break;
+                    case 1:  field += "REsp " + std::to_string(1000000 + rng() % 1500000) + "/SP "; break;
+                    case 2:  field += std::string(word) + ".\n        "; break;
+                    case 3:  field += std::string(word) + ", "; break;
+                    default: field += std::string(word) + ' '; break;
+                }
+            }
+        }
+
+        return fields;
+    }
+
+    template<typename F>
+    void Run(const char* p_Name, const std::vector<std::string>& p_Fields, int p_Rounds, F&& p_Function)
+    {
+        size_t bytes = 0, checksum = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < p_Rounds; round++)
+        {
+            for (const auto& field : p_Fields)
+            {
+                checksum += p_Function(field);
+                bytes += field.size();
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::printf("%-30s %8.1f MB/s  (checksum %zu)\n", p_Name, bytes / seconds / (1024.0 * 1024.0), checksum);
+    }
+
+} // namespace
+
+int main()
+{
+    const int rounds = 10;
+    std::vector<std::string> fields = MakeFields(2000, 4096);
+
+    // the floor every tokenizer pays: one pass over the bytes, nothing kept
+    Run("Byte scan (lower case only)", fields, rounds, [](const std::string& p_Field)
+    {
+        size_t letters = 0;
+        for (char c : p_Field)
+            letters += (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+        return letters;
+    });
+
+    SCPY::Tokenizer tokenizer;
+    Run("Tokenize (warm stem cache)", fields, rounds, [&](const std::string& p_Field)
+    {
+        size_t checksum = 0;
+        tokenizer.Tokenize(p_Field, [&](std::string_view p_Token, uint32_t p_Position) { checksum += p_Token.size() + p_Position; });
+        return checksum;
+    });
+
+    // a fresh tokenizer per field, the stem cache starts empty every time
+    Run("Tokenize (cold stem cache)", fields, 1, [](const std::string& p_Field)
+    {
+        SCPY::Tokenizer fresh;
+        size_t checksum = 0;
+        fresh.Tokenize(p_Field, [&](std::string_view p_Token, uint32_t p_Position) { checksum += p_Token.size() + p_Position; });
+        return checksum;
+    });
+
+    // the stemmer alone, on words already folded, without going through the cache
+    static const char* s_Folded[] = {
+        "recursos", "especiais", "acordaos", "indenizacao", "indenizacoes", "responsabilidade", "tributario", "jurisprudencia",
+        "jurisprudencial", "competencia", "fundamentacao", "provimento", "negado", "administrativos", "previdenciario",
+        "aposentadoria", "desapropriacao", "extraordinario", "possessoria", "declaracao", "honorarios", "advocaticios",
+        "prescricao", "decisoes", "razoes", "contratuais", "consumidores", "provar", "provado", "julgamento",
+    };
+    std::vector<std::string> words(s_Folded, s_Folded + std::size(s_Folded));
+
+    char buffer[SCPY::Tokenizer::s_MaxWordSize];
+    size_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds * 10000; round++)
+    {
+        for (const auto& word : words)
+        {
+            std::memcpy(buffer, word.data(), word.size());
+            checksum += SCPY::StemPortuguese(buffer, word.size());
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%-30s %8.1f ns/word  (checksum %zu)\n", "StemPortuguese", seconds * 1e9 / double(words.size() * rounds * 10000), checksum);
+
+    return 0;
+}
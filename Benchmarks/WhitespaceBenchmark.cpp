@@ -0,0 +1,99 @@
+#include "Parse/Whitespace.h"
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+
+
+namespace
+{
+    // The two pass cleanup the parser used before NormalizeWhitespace
+    std::string Clean(const std::string& p_Text)
+    {
+        std::string newText = p_Text;
+        newText.erase(std::remove_if(newText.begin(), newText.end(), [](char c) 
+        {
+            return c == '\n' || c == '\t' || c == '\r';
+        }), newText.end());
+
+        newText.erase(std::unique(newText.begin(), newText.end(), [](char a, char b) {
+            return a == ' ' && b == ' ';
+        }), newText.end());
+
+        auto pos = newText.find((char)0);
+        if (pos != std::string::npos)
+            newText.erase(pos);
+
+        return newText;
+    }
+
+    // Headnote-like text: words and single spaces, with the line breaks and indentation SCON pages carry
+    std::vector<std::string> MakeFields(size_t p_Count, size_t p_Size)
+    {
+        static const char* s_Words[] = { "PROCESSUAL", "CIVIL", "recurso", "especial", "acórdão", "ementa", "não", "conhecimento", "de", "da", "Súmula", "7/STJ" };
+
+        std::mt19937 rng(42);
+        std::vector<std::string> fields(p_Count);
+        for (auto& field : fields)
+        {
+            while (field.size() < p_Size)
+            {
+                field += s_Words[rng() % std::size(s_Words)];
+                switch (rng() % 24)
+                {
+                    case 0:  field += "\n        "; break;
+                    case 1:  field += " \t"; break;
+                    default: field += ' '; break;
+                }
+            }
+        }
+
+        return fields;
+    }
+
+    template<typename F>
+    void Run(const char* p_Name, const std::vector<std::string>& p_Fields, int p_Rounds, F&& p_Function)
+    {
+        size_t bytes = 0, checksum = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < p_Rounds; round++)
+        {
+            for (const auto& field : p_Fields)
+            {
+                checksum += p_Function(field);
+                bytes += field.size();
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::printf("%-26s %8.1f MB/s  (checksum %zu)\n", p_Name, bytes / seconds / (1024.0 * 1024.0), checksum);
+    }
+
+} // namespace
+
+int main()
+{
+    const int rounds = 50;
+    std::vector<std::string> fields = MakeFields(2000, 4096);
+    std::string buffer(8192, '\0');
+
+    std::printf("Dispatched kernel: %s\n\n", SCPY::GetWhitespaceKernelName());
+
+    Run("Clean (remove_if+unique)", fields, rounds, [](const std::string& p_Field) { return Clean(p_Field).size(); });
+    Run("Scalar single pass", fields, rounds, [&](const std::string& p_Field) 
+    { 
+        return SCPY::NormalizeWhitespaceScalar(p_Field.data(), p_Field.size(), buffer.data()); 
+    });
+    Run("Dispatched", fields, rounds, [&](const std::string& p_Field) 
+    { 
+        return SCPY::NormalizeWhitespace(p_Field.data(), p_Field.size(), buffer.data()); 
+    });
+
+    return 0;
+}
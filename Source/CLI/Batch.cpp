@@ -0,0 +1,262 @@
+#include "Batch.h"
+#include "Core/Base.h"
+#include "Core/Search.h"
+#include "Core/Crawler.h"
+#include "Core/Corpus.h"
+#include "Index/InvertedIndex.h"
+#include "Net/ConcurrencyLimiter.h"
+#include "Export/AsyncSink.h"
+#include "Export/ExportFormat.h"
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+
+namespace SCPY
+{
+    namespace
+    {
+        std::atomic<bool> s_Interrupted = false;
+
+        void OnInterrupt(int)
+        {
+            s_Interrupted = true;
+        }
+
+        void PrintUsage()
+        {
+            LOG("Usage: Scrapper --term <term> [options]");
+            LOG("       Scrapper --corpus <file.scpc> --query <query> [--limit <count>]");
+            LOG("  --pages <pages>       all (default), or 1 based pages and ranges like 1-5,8");
+            LOG("  --out <file>          output, Crawl-<term>.<format> by default");
+            LOG("  --format <format>     yml, jsonl, csv or scpc (binary corpus), from the --out extension by default");
+            LOG("  --docs <per page>     results per page, the config's page size by default");
+            LOG("  --workers <count>     most pages fetched at once (16)");
+            LOG("  --checkpoint <file>   resume file, <out>.checkpoint by default");
+            LOG("  --config <file>       settings and extraction schema (Scrapper.yml)");
+            LOG("  --query <query>       searches a crawled corpus, e.g. \"dano moral\" e (banco ou financeira) não seguro");
+            LOG("  --limit <count>       most matches printed (20)");
+        }
+
+        // "all" leaves p_Pages empty, which the crawl reads as every page
+        bool ParsePages(const std::string& p_Spec, std::vector<int>& p_Pages)
+        {
+            p_Pages.clear();
+            if (p_Spec == "all")
+                return true;
+
+            size_t start = 0;
+            while (start <= p_Spec.size())
+            {
+                size_t end = p_Spec.find(',', start);
+                if (end == std::string::npos)
+                    end = p_Spec.size();
+
+                std::string item = p_Spec.substr(start, end - start);
+                size_t dash = item.find('-');
+
+                int first = 0, last = 0;
+                try
+                {
+                    first = std::stoi(item.substr(0, dash));
+                    last = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+                }
+                catch (const std::exception&)
+                {
+                    return false;
+                }
+
+                if (first < 1 || last < first)
+                    return false;
+
+                for (int page = first; page <= last; page++)
+                    p_Pages.push_back(page - 1);
+
+                start = end + 1;
+            }
+
+            std::sort(p_Pages.begin(), p_Pages.end());
+            p_Pages.erase(std::unique(p_Pages.begin(), p_Pages.end()), p_Pages.end());
+            return true;
+        }
+
+        int RunQuery(const std::string& p_Path, const std::string& p_Query, size_t p_Limit)
+        {
+            auto corpus = Corpus::Open(p_Path);
+            if (!corpus)
+                return 1;
+
+            auto start = std::chrono::steady_clock::now();
+            auto index = InvertedIndex::Build(*corpus);
+            auto built = std::chrono::steady_clock::now();
+            auto hits = index->Search(p_Query, p_Limit);
+            auto searched = std::chrono::steady_clock::now();
+
+            LOG("Indexed {} records, {} terms, {} KB in {} ms", index->GetDocCount(), index->GetTermCount(), index->GetByteSize() / 1024,
+                std::chrono::duration_cast<std::chrono::milliseconds>(built - start).count());
+            LOG("{} matches in {} us", hits.size(), std::chrono::duration_cast<std::chrono::microseconds>(searched - built).count());
+
+            for (const auto& hit : hits)
+            {
+                LawsuitView lawsuit = corpus->Get(hit.Doc);
+                LOG("{:8.3f}  {}  {}", hit.Score, lawsuit.Case, lawsuit.PubDate);
+            }
+            return hits.empty() ? 1 : 0;
+        }
+
+    } // namespace
+
+    // Scrapper --term <term> [--pages <pages>] [--out <file>] [--format <format>] [--docs <per page>] [--workers <count>] [--checkpoint <file>] [--config <file>]
+    // Running the same command again after an interruption resumes from the checkpoint.
+    // Scrapper --corpus <file.scpc> --query <query> [--limit <count>] searches a finished crawl instead.
+    int RunBatch(int p_Argc, char** p_Argv)
+    {
+        std::string term = "";
+        std::string pages = "all";
+        std::string out = "";
+        std::string format = "";
+        int docsPerPage = 0;
+        uint32_t workers = 16;
+        std::string checkpoint = "";
+        std::string config = "Scrapper.yml";
+        std::string corpus = "";
+        std::string query = "";
+        size_t limit = 20;
+
+        for (int i = 1; i < p_Argc; i++)
+        {
+            std::string option = p_Argv[i];
+            if (option == "--help" || option == "-h")
+            {
+                PrintUsage();
+                return 0;
+            }
+
+            if (i + 1 >= p_Argc)
+            {
+                LOG("ERROR: {} needs a value", option);
+                PrintUsage();
+                return 2;
+            }
+
+            std::string value = p_Argv[++i];
+            try
+            {
+                // --crawl is the older spelling of --term
+                if (option == "--term" || option == "--crawl")
+                    term = value;
+                else if (option == "--pages")
+                    pages = value;
+                else if (option == "--out")
+                    out = value;
+                else if (option == "--format")
+                    format = value;
+                else if (option == "--docs")
+                    docsPerPage = std::stoi(value);
+                else if (option == "--workers")
+                    workers = (uint32_t)std::stoul(value);
+                else if (option == "--checkpoint")
+                    checkpoint = value;
+                else if (option == "--config")
+                    config = value;
+                else if (option == "--corpus")
+                    corpus = value;
+                else if (option == "--query")
+                    query = value;
+                else if (option == "--limit")
+                    limit = std::stoul(value);
+                else
+                    LOG("WARNING: Unknown option {}", option);
+            }
+            catch (const std::exception&)
+            {
+                LOG("ERROR: Invalid value '{}' for {}", value, option);
+                return 2;
+            }
+        }
+
+        if (!corpus.empty())
+        {
+            if (query.empty())
+            {
+                PrintUsage();
+                return 2;
+            }
+            return RunQuery(corpus, query, limit);
+        }
+
+        CrawlOptions options;
+        if (term.empty() || !ParsePages(pages, options.Pages))
+        {
+            PrintUsage();
+            return 2;
+        }
+
+        ExportFormat exportFormat = ExportFormat::Yaml;
+        if (!format.empty())
+        {
+            auto found = FindExportFormat(format);
+            if (!found)
+            {
+                LOG("ERROR: Unknown format '{}'", format);
+                return 2;
+            }
+            exportFormat = *found;
+        }
+        else if (auto found = FindExportFormat(std::filesystem::path(out).extension().string()))
+            exportFormat = *found;
+
+        if (out.empty())
+        {
+            out = term;
+            std::replace(out.begin(), out.end(), ' ', '-');
+            out = "Crawl-" + out + std::string(GetExtension(exportFormat));
+        }
+
+        if (checkpoint.empty())
+            checkpoint = out + ".checkpoint";
+
+        Search search;
+        search.SetDocsPerPage(50);
+        search.LoadConfig(config);
+        if (docsPerPage > 0)
+            search.SetDocsPerPage(docsPerPage);
+
+        options.Workers = workers;
+        options.Checkpoint = checkpoint;
+
+        // Ctrl+C stops the crawl cleanly, the checkpoint lets the next run pick up from there
+        std::signal(SIGINT, OnInterrupt);
+        std::signal(SIGTERM, OnInterrupt);
+
+        auto sink = std::make_shared<AsyncSink>(CreateExportSink(exportFormat, out));
+        auto job = search.Crawl(term, sink, options);
+        while (!job->IsDone())
+        {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            if (s_Interrupted && !job->IsCancelled())
+            {
+                LOG("Interrupted, saving the checkpoint to {}", checkpoint);
+                job->Cancel();
+            }
+
+            LOG("{} / {} pages, {} records, {} concurrent requests", job->GetCompletedPages(), job->GetTotalPages(), 
+                job->GetRecordCount(), search.GetConcurrencyLimiter()->GetLimit());
+        }
+        job->Wait();
+        sink->Wait();
+
+        LOG("Wrote {} records of '{}' to {} ({} pages failed, {} retries)", job->GetRecordCount(), term, out, job->GetFailedPages(), job->GetRetryCount());
+        for (const auto& letter : job->GetDeadLetters())
+            LOG("  page {}: {}", letter.Page + 1, letter.Error);
+        return job->GetFailedPages() == 0 && job->GetTotalPages() > 0 && !job->IsCancelled() ? 0 : 1;
+    }
+
+} // namespace SCPY
@@ -0,0 +1,11 @@
+#pragma once
+
+
+
+namespace SCPY
+{
+    // Headless crawl and export, it only needs Search: no window, no OpenGL and no ImGui.
+    // Returns the process exit code.
+    int RunBatch(int p_Argc, char** p_Argv);
+
+} // namespace SCPY
@@ -0,0 +1,8 @@
+#include "Batch.h"
+
+
+
+int main(int argc, char** argv)
+{
+    return SCPY::RunBatch(argc, argv);
+}
@@ -5,6 +5,10 @@
 #include "Events/MouseEvent.h"
 #include "Events/WindowEvent.h"
 #include "MaterialDesignIcons.h"
+#include "Export/AsyncSink.h"
+#include "Export/ExportFormat.h"
+#include "Export/TableSink.h"
+#include "Net/ConcurrencyLimiter.h"
 
 // lib
 #define GLFW_INCLUDE_NONE
@@ -18,6 +22,9 @@ namespace SCPY
 {
     namespace
     {
+        // next to the executable's working directory, written back on exit
+        constexpr const char* s_ConfigPath = "Scrapper.yml";
+
         void BeginDockspace(std::string p_ID, std::string p_Dockspace, bool p_MenuBar, ImGuiDockNodeFlags p_DockFlags = 0)
         {
             static bool opt_fullscreen = true;
@@ -139,6 +146,25 @@ namespace SCPY
             return updated;
         }
 
+        // best first, more than anyone scrolls through
+        constexpr size_t s_MaxCorpusHits = 10000;
+
+        // what each column of the corpus browser sorts by
+        constexpr LawsuitField s_CorpusColumns[] = { LawsuitField::Case, LawsuitField::Rapporteur, LawsuitField::JudgmentDate, LawsuitField::PubDate };
+
+        std::filesystem::path GetCrawlPath(const std::string& p_Term, ExportFormat p_Format)
+        {
+            std::string file = p_Term;
+            std::replace(file.begin(), file.end(), ' ', '-');
+            return "Crawl-" + file + std::string(GetExtension(p_Format));
+        }
+
+        // the crawl thread only copies the records, the writer thread formats them
+        std::shared_ptr<AsyncSink> CreateCrawlSink(const std::string& p_Term, ExportFormat p_Format)
+        {
+            return std::make_shared<AsyncSink>(CreateExportSink(p_Format, GetCrawlPath(p_Term, p_Format)));
+        }
+
     } // namespace
 
     Application::Application()
@@ -159,10 +185,12 @@ namespace SCPY
 
         m_Search = std::make_shared<Search>();
         m_Search->SetDocsPerPage(50);
+        m_Search->LoadConfig(s_ConfigPath);
     }
 
     Application::~Application()
     {
+        m_Search->SaveConfig(s_ConfigPath);
         s_Instance = nullptr;
     }
 
@@ -220,6 +248,8 @@ namespace SCPY
 		ImGui::SetNextWindowDockID(dockID, ImGuiCond_Always);
         ImGui::Begin("Viewport");
         {
+            m_Search->Update();
+
             auto size = ImGui::GetContentRegionAvail();
             float lineHeight = GImGui->Font->LegacySize + GImGui->Style.FramePadding.y * 2.0f;
 
@@ -230,20 +260,34 @@ namespace SCPY
                 m_Search->SearchTerm(term);
             }
          
-            auto lawsuits = m_Search->GetLawsuits();
+            if (!m_Search->GetLastError().empty() && !m_Search->IsLoading())
+                ImGui::TextColored({ 1.0f, 0.4f, 0.4f, 1.0f }, ICON_MDI_ALERT " %s", m_Search->GetLastError().c_str());
+
+            const auto& lawsuits = m_Search->GetLawsuits();
+            if (lawsuits.empty() && m_Search->IsLoading())
+            {
+                ImGui::Text(ICON_MDI_TIMER_SAND " Loading...");
+            }
+
             if (!lawsuits.empty())
             {
                 int total = m_Search->GetTotalResults();
                 int current = (m_Search->GetCurrentPage() * m_Search->GetDocsPerPage()) + 1;
                 ImGui::Text("Results %i of %i", current, total);
 
+                if (m_Search->IsLoading())
+                {
+                    ImGui::SameLine();
+                    ImGui::Text(ICON_MDI_TIMER_SAND " Loading page %i...", m_Search->GetTargetPage());
+                }
+
                 ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, { 0.0f, 0.0f });
                 ImGui::BeginChild("##Content", { size.x, size.y - (lineHeight * 3.4f) }, false);
                 ImGui::PopStyleVar();
                 {
                     for (auto& lawsuit : lawsuits)
                     {
-                        ImGui::PushID(lawsuit.Case.c_str());
+                        ImGui::PushID(lawsuit.Case.data(), lawsuit.Case.data() + lawsuit.Case.size());
                         ImGui::PushStyleVar(ImGuiStyleVar_ChildRounding, 8.0f);
                         ImGui::SetNextWindowSize({0, 512}, ImGuiCond_Once);
                         ImGui::BeginChild("Lawsuit", {0, 0}, ImGuiChildFlags_AlwaysAutoResize | ImGuiChildFlags_AutoResizeY | ImGuiChildFlags_Borders);
@@ -251,14 +295,14 @@ namespace SCPY
                         {
                             if (InviButton(ICON_MDI_CONTENT_COPY "##1", {0, lineHeight}))
                             {
-                                ImGui::SetClipboardText(lawsuit.Case.c_str());
+                                ImGui::SetClipboardText(lawsuit.Case.data());
                                 m_ShowCopyPopup = true;
                                 m_CopyPopupTimer = m_CopyPopupDuration;
                             }
                             ImGui::SameLine();
                             ImGui::Text("CASE");
 
-                            ImGui::TextWrapped(lawsuit.Case.c_str());
+                            ImGui::TextWrapped("%s", lawsuit.Case.data());
                             ImGui::NewLine();
 
                             auto available = ImGui::GetContentRegionAvail().x;
@@ -266,14 +310,14 @@ namespace SCPY
                             {
                                 if (InviButton(ICON_MDI_CONTENT_COPY "##2", {0, lineHeight}))
                                 {
-                                    ImGui::SetClipboardText(lawsuit.JudgmentDate.c_str());
+                                    ImGui::SetClipboardText(lawsuit.JudgmentDate.data());
                                     m_ShowCopyPopup = true;
                                     m_CopyPopupTimer = m_CopyPopupDuration;
                                 }
                                 ImGui::SameLine();
                                 ImGui::Text("JUDGMENT DATE");
 
-                                ImGui::TextWrapped(lawsuit.JudgmentDate.c_str());
+                                ImGui::TextWrapped("%s", lawsuit.JudgmentDate.data());
                             }
                             ImGui::EndChild();
                             ImGui::SameLine();
@@ -281,14 +325,14 @@ namespace SCPY
                             {
                                 if (InviButton(ICON_MDI_CONTENT_COPY "##3", {0, lineHeight}))
                                 {
-                                    ImGui::SetClipboardText(lawsuit.PubDate.c_str());
+                                    ImGui::SetClipboardText(lawsuit.PubDate.data());
                                     m_ShowCopyPopup = true;
                                     m_CopyPopupTimer = m_CopyPopupDuration;
                                 }
                                 ImGui::SameLine();
                                 ImGui::Text("PUBLICATION DATE");
 
-                                ImGui::TextWrapped(lawsuit.PubDate.c_str());
+                                ImGui::TextWrapped("%s", lawsuit.PubDate.data());
                             }
                             ImGui::EndChild();
 
@@ -296,38 +340,38 @@ namespace SCPY
 
                             if (InviButton(ICON_MDI_CONTENT_COPY "##4", {0, lineHeight}))
                             {
-                                ImGui::SetClipboardText(lawsuit.Rapporteur.c_str());
+                                ImGui::SetClipboardText(lawsuit.Rapporteur.data());
                                 m_ShowCopyPopup = true;
                                 m_CopyPopupTimer = m_CopyPopupDuration;
                             }
                             ImGui::SameLine();
                             ImGui::Text("RAPPORTEUR");
 
-                            ImGui::TextWrapped(lawsuit.Rapporteur.c_str());
+                            ImGui::TextWrapped("%s", lawsuit.Rapporteur.data());
                             ImGui::NewLine();
 
                             if (InviButton(ICON_MDI_CONTENT_COPY "##5", {0, lineHeight}))
                             {
-                                ImGui::SetClipboardText(lawsuit.Headnote.c_str());
+                                ImGui::SetClipboardText(lawsuit.Headnote.data());
                                 m_ShowCopyPopup = true;
                                 m_CopyPopupTimer = m_CopyPopupDuration;
                             }
                             ImGui::SameLine();
                             ImGui::Text("HEADNOTE");
 
-                            ImGui::TextWrapped(lawsuit.Headnote.c_str());
+                            ImGui::TextWrapped("%s", lawsuit.Headnote.data());
                             ImGui::NewLine();
 
                             if (InviButton(ICON_MDI_CONTENT_COPY "##6", {0, lineHeight}))
                             {
-                                ImGui::SetClipboardText(lawsuit.Decision.c_str());
+                                ImGui::SetClipboardText(lawsuit.Decision.data());
                                 m_ShowCopyPopup = true;
                                 m_CopyPopupTimer = m_CopyPopupDuration;
                             }
                             ImGui::SameLine();
                             ImGui::Text("DECISION");
 
-                            ImGui::TextWrapped(lawsuit.Decision.c_str());
+                            ImGui::TextWrapped("%s", lawsuit.Decision.data());
                         }
                         ImGui::EndChild();
                         ImGui::PopID();
@@ -360,8 +404,86 @@ namespace SCPY
 
                 ImGui::SameLine();
 
+                ImGui::SetNextItemWidth(ImGui::CalcTextSize(s_ExportFormatNames[size_t(ExportFormat::JsonLines)]).x + lineHeight * 2.0f);
+                int format = (int)m_ExportFormat;
+                if (ImGui::Combo("##ExportFormat", &format, s_ExportFormatNames, (int)ExportFormat::Count))
+                    m_ExportFormat = (ExportFormat)format;
+
+                ImGui::SameLine();
+
                 if (ImGui::Button("Export " ICON_MDI_FILE_EXPORT, { 0, lineHeight }))
-                    m_Search->ExportYML();
+                    m_Search->Export(m_ExportFormat);
+
+                ImGui::SameLine();
+
+                if (m_Crawl && !m_Crawl->IsDone())
+                {
+                    if (InviButton(ICON_MDI_CANCEL, { 0, lineHeight }))
+                        m_Crawl->Cancel();
+
+                    ImGui::SameLine();
+
+                    size_t totalPages = m_Crawl->GetTotalPages();
+                    float progress = totalPages > 0 ? float(m_Crawl->GetCompletedPages()) / float(totalPages) : 0.0f;
+                    std::string overlay = std::format("{} / {} pages, {} records, {} concurrent requests", m_Crawl->GetCompletedPages(), totalPages, 
+                        m_Crawl->GetRecordCount(), m_Search->GetConcurrencyLimiter()->GetLimit());
+                    ImGui::ProgressBar(progress, { -1.0f, lineHeight }, overlay.c_str());
+                }
+                else
+                {
+                    if (ImGui::Button("Crawl all " ICON_MDI_SPIDER_WEB, { 0, lineHeight }))
+                    {
+                        std::filesystem::path file = GetCrawlPath(m_Search->GetTerm(), m_ExportFormat);
+
+                        // an interrupted crawl of the same term carries on where it stopped
+                        CrawlOptions options;
+                        options.Checkpoint = file;
+                        options.Checkpoint += ".checkpoint";
+                        m_CrawlFormat = m_ExportFormat;
+                        m_CrawlSink = CreateCrawlSink(m_Search->GetTerm(), m_CrawlFormat);
+                        m_Crawl = m_Search->Crawl(m_Search->GetTerm(), m_CrawlSink, options);
+                    }
+
+                    if (m_Crawl)
+                    {
+                        ImGui::SameLine();
+                        ImGui::Text("%s %zu records from '%s'%s", m_Crawl->IsCancelled() ? ICON_MDI_CANCEL : ICON_MDI_CHECK_CIRCLE, 
+                            m_Crawl->GetRecordCount(), m_Crawl->GetTerm().c_str(), m_Crawl->IsResumed() ? " (resumed)" : "");
+
+                        if (m_Crawl->GetFailedPages() > 0)
+                        {
+                            ImGui::SameLine();
+                            std::string label = std::format(ICON_MDI_REFRESH " Retry {} failed pages", m_Crawl->GetFailedPages());
+                            if (ImGui::Button(label.c_str(), { 0, lineHeight }))
+                            {
+                                auto sink = CreateCrawlSink(m_Crawl->GetTerm(), m_CrawlFormat);
+                                if (auto retry = m_Search->Recrawl(*m_Crawl, sink))
+                                {
+                                    m_Crawl = retry;
+                                    m_CrawlSink = sink;
+                                }
+                            }
+                        }
+
+                        if (m_CrawlFormat == ExportFormat::Corpus)
+                        {
+                            ImGui::SameLine();
+                            if (ImGui::Button("Browse " ICON_MDI_DATABASE, { 0, lineHeight }))
+                            {
+                                // the writer joins the corpus parts once the crawl closes it
+                                m_CrawlSink->Wait();
+                                m_Corpus = Corpus::Open(GetCrawlPath(m_Crawl->GetTerm(), ExportFormat::Corpus));
+                                m_Index.reset();
+                                m_CorpusHits.clear();
+                                m_QueryPending = false;
+                                m_ShowHits = false;
+                                m_CorpusTable.reset();
+                                m_CorpusOrder.clear();
+                                m_RapporteurCounts.clear();
+                            }
+                        }
+                    }
+                }
             }
 
             if (m_ShowCopyPopup)
@@ -391,5 +513,218 @@ namespace SCPY
             }
         }
         ImGui::End();
+
+        UpdateCorpusIndex();
+        UpdateCorpusTable();
+        if (m_Corpus)
+            OnCorpusImgui();
+    }
+
+    void Application::UpdateCorpusIndex()
+    {
+        if (m_IndexBuild.valid() && m_IndexBuild.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        {
+            auto index = m_IndexBuild.get();
+            if (m_IndexCorpus == m_Corpus)
+                m_Index = std::move(index);
+            m_IndexCorpus.reset();
+        }
+
+        if (!m_Corpus || !m_QueryPending)
+            return;
+
+        if (m_Index)
+        {
+            m_CorpusHits = m_Index->Search(m_CorpusQuery, s_MaxCorpusHits);
+            m_QueryPending = false;
+            m_ShowHits = true;
+            SortCorpusHits();
+        }
+        else if (!m_IndexBuild.valid())
+        {
+            // browsing alone never pays for the index
+            if (!m_Indexer)
+                m_Indexer = std::make_unique<ThreadPool>(1);
+
+            m_IndexCorpus = m_Corpus;
+            m_IndexBuild = m_Indexer->Submit([corpus = m_Corpus]()
+            {
+                return std::shared_ptr<const InvertedIndex>(InvertedIndex::Build(*corpus));
+            });
+        }
+    }
+
+    void Application::UpdateCorpusTable()
+    {
+        if (m_TableBuild.valid() && m_TableBuild.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        {
+            auto table = m_TableBuild.get();
+            if (m_TableCorpus == m_Corpus)
+            {
+                m_CorpusTable = std::move(table);
+                m_RapporteurCounts = m_CorpusTable->CountBy(LawsuitField::Rapporteur);
+            }
+            m_TableCorpus.reset();
+        }
+
+        if (!m_Corpus || m_CorpusTable || m_TableBuild.valid())
+            return;
+
+        if (!m_Indexer)
+            m_Indexer = std::make_unique<ThreadPool>(1);
+
+        m_TableCorpus = m_Corpus;
+        m_TableBuild = m_Indexer->Submit([corpus = m_Corpus]()
+        {
+            auto table = std::make_shared<LawsuitTable>();
+            TableSink sink(*table);
+            sink.Open(std::string(corpus->GetTerm()), corpus->GetCount());
+
+            // the long fields stay in the mapping, the browser reads them only for visible rows
+            for (size_t i = 0; i < corpus->GetCount(); i++)
+            {
+                LawsuitView lawsuit = corpus->Get(i);
+                lawsuit.Headnote = {};
+                lawsuit.Decision = {};
+                sink.Write(lawsuit);
+            }
+            sink.Close();
+
+            return std::shared_ptr<const LawsuitTable>(std::move(table));
+        });
+    }
+
+    void Application::SortCorpusHits()
+    {
+        // without a sort the matches go back to best first
+        if (m_CorpusOrder.empty())
+        {
+            std::stable_sort(m_CorpusHits.begin(), m_CorpusHits.end(), [](const SearchHit& a, const SearchHit& b) { return a.Score > b.Score; });
+            return;
+        }
+
+        std::vector<uint32_t> rank(m_CorpusOrder.size());
+        for (uint32_t i = 0; i < (uint32_t)m_CorpusOrder.size(); i++)
+            rank[m_CorpusOrder[i]] = i;
+
+        std::sort(m_CorpusHits.begin(), m_CorpusHits.end(), [&rank](const SearchHit& a, const SearchHit& b) { return rank[a.Doc] < rank[b.Doc]; });
+    }
+
+    void Application::OnCorpusImgui()
+    {
+        bool open = true;
+        std::string title = std::format(ICON_MDI_DATABASE " {} ({} records)###Corpus", m_Corpus->GetTerm(), m_Corpus->GetCount());
+
+        ImGui::SetNextWindowSize({ 960, 540 }, ImGuiCond_FirstUseEver);
+        if (ImGui::Begin(title.c_str(), &open))
+        {
+            ImGuiInputTextFlags inputFlags = ImGuiInputTextFlags_EnterReturnsTrue | ImGuiInputTextFlags_AutoSelectAll | ImGuiInputTextFlags_EscapeClearsAll;
+            if (InputText(ICON_MDI_MAGNIFY, m_CorpusQuery, true, 4.0f, true, inputFlags))
+            {
+                m_QueryPending = !m_CorpusQuery.empty();
+                m_ShowHits = false;
+                m_CorpusHits.clear();
+            }
+
+            if (m_QueryPending)
+                ImGui::Text(ICON_MDI_TIMER_SAND " Indexing %zu records...", m_Corpus->GetCount());
+            else if (m_ShowHits)
+                ImGui::Text("%zu matches for '%s'", m_CorpusHits.size(), m_CorpusQuery.c_str());
+
+            if (!m_RapporteurCounts.empty() && ImGui::TreeNode("Records by rapporteur"))
+            {
+                for (const auto& [rapporteur, count] : m_RapporteurCounts)
+                    ImGui::Text("%8zu  %.*s", count, (int)rapporteur.size(), rapporteur.data());
+                ImGui::TreePop();
+            }
+
+            // tristate, so the records can go back to file order
+            ImGuiTableFlags flags = ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_Resizable |
+                                    ImGuiTableFlags_Sortable | ImGuiTableFlags_SortTristate;
+            if (ImGui::BeginTable("##Records", 4, flags))
+            {
+                ImGui::TableSetupScrollFreeze(0, 1);
+                ImGui::TableSetupColumn("CASE");
+                ImGui::TableSetupColumn("RAPPORTEUR");
+                ImGui::TableSetupColumn("JUDGMENT DATE");
+                ImGui::TableSetupColumn("PUBLICATION DATE");
+                ImGui::TableHeadersRow();
+
+                // stays dirty until the table is built, the sort is applied as soon as it is
+                ImGuiTableSortSpecs* sortSpecs = ImGui::TableGetSortSpecs();
+                if (sortSpecs && sortSpecs->SpecsDirty && m_CorpusTable)
+                {
+                    if (sortSpecs->SpecsCount > 0)
+                    {
+                        const ImGuiTableColumnSortSpecs& spec = sortSpecs->Specs[0];
+                        m_CorpusOrder = m_CorpusTable->SortBy(s_CorpusColumns[spec.ColumnIndex], spec.SortDirection == ImGuiSortDirection_Descending);
+                    }
+                    else
+                    {
+                        m_CorpusOrder.clear();
+                    }
+
+                    SortCorpusHits();
+                    sortSpecs->SpecsDirty = false;
+                }
+
+                // only the visible rows are read from the mapping
+                ImGuiListClipper clipper;
+                clipper.Begin(m_ShowHits ? (int)m_CorpusHits.size() : (int)m_Corpus->GetCount());
+                while (clipper.Step())
+                {
+                    for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++)
+                    {
+                        size_t record = m_ShowHits ? m_CorpusHits[row].Doc : m_CorpusOrder.empty() ? (size_t)row : m_CorpusOrder[row];
+                        LawsuitView lawsuit = m_Corpus->Get(record);
+
+                        ImGui::TableNextRow();
+                        ImGui::PushID(row);
+
+                        ImGui::TableNextColumn();
+                        if (ImGui::Selectable(lawsuit.Case.data(), false, ImGuiSelectableFlags_SpanAllColumns))
+                        {
+                            ImGui::SetClipboardText(lawsuit.Headnote.data());
+                            m_ShowCopyPopup = true;
+                            m_CopyPopupTimer = m_CopyPopupDuration;
+                        }
+
+                        if (ImGui::IsItemHovered() && !lawsuit.Headnote.empty())
+                        {
+                            ImGui::BeginTooltip();
+                            ImGui::PushTextWrapPos(ImGui::GetFontSize() * 40.0f);
+                            ImGui::TextUnformatted(lawsuit.Headnote.data(), lawsuit.Headnote.data() + lawsuit.Headnote.size());
+                            ImGui::PopTextWrapPos();
+                            ImGui::EndTooltip();
+                        }
+
+                        ImGui::TableNextColumn();
+                        ImGui::TextUnformatted(lawsuit.Rapporteur.data(), lawsuit.Rapporteur.data() + lawsuit.Rapporteur.size());
+                        ImGui::TableNextColumn();
+                        ImGui::TextUnformatted(lawsuit.JudgmentDate.data(), lawsuit.JudgmentDate.data() + lawsuit.JudgmentDate.size());
+                        ImGui::TableNextColumn();
+                        ImGui::TextUnformatted(lawsuit.PubDate.data(), lawsuit.PubDate.data() + lawsuit.PubDate.size());
+
+                        ImGui::PopID();
+                    }
+                }
+
+                ImGui::EndTable();
+            }
+        }
+        ImGui::End();
+
+        if (!open)
+        {
+            // a running index build is left to finish, its result is dropped
+            m_Corpus.reset();
+            m_Index.reset();
+            m_CorpusHits.clear();
+            m_QueryPending = false;
+            m_ShowHits = false;
+            m_CorpusTable.reset();
+            m_CorpusOrder.clear();
+            m_RapporteurCounts.clear();
+        }
     }
 } // namespace SCPY
@@ -3,8 +3,16 @@
 #include "Window.h"
 #include "ImGuiLayer.h"
 #include "Search.h"
+#include "Crawler.h"
+#include "Export/ExportFormat.h"
+#include "Export/AsyncSink.h"
+#include "Corpus.h"
+#include "LawsuitTable.h"
+#include "ThreadPool.h"
+#include "Index/InvertedIndex.h"
 
 // std
+#include <future>
 #include <memory>
 
 
@@ -29,11 +37,37 @@ namespace SCPY
         private:
             void Init();
             void OnImgui();
+            void OnCorpusImgui();
+            void UpdateCorpusIndex();
+            void UpdateCorpusTable();
+            void SortCorpusHits();
 
         private:
             static inline Application* s_Instance = nullptr;
 
             std::shared_ptr<Search> m_Search;
+            std::shared_ptr<CrawlJob> m_Crawl;
+            ExportFormat m_ExportFormat = ExportFormat::Yaml;
+            ExportFormat m_CrawlFormat = ExportFormat::Yaml; // a retry has to append to the same file
+            std::shared_ptr<AsyncSink> m_CrawlSink;
+            std::shared_ptr<const Corpus> m_Corpus;
+
+            // built on the first search of a corpus, kept while the window is open
+            std::shared_ptr<const InvertedIndex> m_Index;
+            std::unique_ptr<ThreadPool> m_Indexer;
+            std::future<std::shared_ptr<const InvertedIndex>> m_IndexBuild;
+            std::shared_ptr<const Corpus> m_IndexCorpus;
+            std::string m_CorpusQuery = "";
+            std::vector<SearchHit> m_CorpusHits;
+            bool m_QueryPending = false;
+            bool m_ShowHits = false;
+
+            // the short columns of the corpus, built when it opens, so sorting and counting never touch a headnote
+            std::shared_ptr<const LawsuitTable> m_CorpusTable;
+            std::future<std::shared_ptr<const LawsuitTable>> m_TableBuild;
+            std::shared_ptr<const Corpus> m_TableCorpus;
+            std::vector<uint32_t> m_CorpusOrder; // rows in the chosen sort, empty keeps the file order
+            std::vector<std::pair<std::string_view, size_t>> m_RapporteurCounts;
 
             std::shared_ptr<Window> m_Window;
             std::shared_ptr<ImGuiLayer> m_ImGuiLayer;
@@ -0,0 +1,114 @@
+#include "Arena.h"
+
+// std
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+
+
+namespace SCPY
+{
+    Arena::Arena(size_t p_BlockSize)
+        : m_BlockSize(std::max<size_t>(p_BlockSize, 64))
+    {
+    }
+
+    Arena::Arena(Arena&& p_Other) noexcept
+        : m_Blocks(std::move(p_Other.m_Blocks)), m_Cursor(std::exchange(p_Other.m_Cursor, nullptr)), m_End(std::exchange(p_Other.m_End, nullptr)),
+          m_BlockSize(p_Other.m_BlockSize), m_Used(std::exchange(p_Other.m_Used, 0)), m_Capacity(std::exchange(p_Other.m_Capacity, 0))
+    {
+        p_Other.m_Blocks.clear();
+    }
+
+    Arena& Arena::operator=(Arena&& p_Other) noexcept
+    {
+        if (this == &p_Other)
+            return *this;
+
+        m_Blocks = std::move(p_Other.m_Blocks);
+        p_Other.m_Blocks.clear();
+
+        m_Cursor = std::exchange(p_Other.m_Cursor, nullptr);
+        m_End = std::exchange(p_Other.m_End, nullptr);
+        m_BlockSize = p_Other.m_BlockSize;
+        m_Used = std::exchange(p_Other.m_Used, 0);
+        m_Capacity = std::exchange(p_Other.m_Capacity, 0);
+        return *this;
+    }
+
+    void* Arena::Allocate(size_t p_Size, size_t p_Alignment)
+    {
+        // a big value gets a block of its own instead of wasting the rest of the current one
+        if (p_Size + p_Alignment > m_BlockSize / 4)
+        {
+            char* data = AddBlock(p_Size + p_Alignment, false);
+            uintptr_t aligned = ((uintptr_t)data + p_Alignment - 1) & ~(uintptr_t)(p_Alignment - 1);
+
+            m_Used += p_Size + p_Alignment;
+            return (void*)aligned;
+        }
+
+        uintptr_t cursor = (uintptr_t)m_Cursor;
+        uintptr_t aligned = (cursor + p_Alignment - 1) & ~(uintptr_t)(p_Alignment - 1);
+
+        if (!m_Cursor || aligned + p_Size > (uintptr_t)m_End)
+        {
+            AddBlock(m_BlockSize, true);
+
+            cursor = (uintptr_t)m_Cursor;
+            aligned = (cursor + p_Alignment - 1) & ~(uintptr_t)(p_Alignment - 1);
+        }
+
+        m_Used += aligned + p_Size - cursor;
+        m_Cursor = (char*)(aligned + p_Size);
+        return (void*)aligned;
+    }
+
+    std::string_view Arena::Store(std::string_view p_Text)
+    {
+        char* data = (char*)Allocate(p_Text.size() + 1, 1);
+        if (!p_Text.empty())
+            std::memcpy(data, p_Text.data(), p_Text.size());
+        data[p_Text.size()] = '\0';
+
+        return { data, p_Text.size() };
+    }
+
+    void Arena::Reset()
+    {
+        auto regular = std::find_if(m_Blocks.begin(), m_Blocks.end(), [this](const Block& p_Block) { return p_Block.Size == m_BlockSize; });
+        if (regular != m_Blocks.end())
+        {
+            Block kept = std::move(*regular);
+            m_Blocks.clear();
+            m_Blocks.push_back(std::move(kept));
+        }
+        else
+            m_Blocks.clear();
+
+        m_Cursor = m_Blocks.empty() ? nullptr : m_Blocks.front().Data.get();
+        m_End = m_Cursor ? m_Cursor + m_BlockSize : nullptr;
+        m_Capacity = m_Cursor ? m_BlockSize : 0;
+        m_Used = 0;
+    }
+
+    char* Arena::AddBlock(size_t p_Size, bool p_MakeCurrent)
+    {
+        Block block;
+        block.Data = std::make_unique_for_overwrite<char[]>(p_Size);
+        block.Size = p_Size;
+
+        char* data = block.Data.get();
+        if (p_MakeCurrent)
+        {
+            m_Cursor = data;
+            m_End = data + p_Size;
+        }
+
+        m_Capacity += p_Size;
+        m_Blocks.push_back(std::move(block));
+        return data;
+    }
+
+} // namespace SCPY
@@ -0,0 +1,57 @@
+#pragma once
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+
+
+namespace SCPY
+{
+    // Bump allocator, memory is only given back all at once by Reset or the destructor.
+    // Blocks never move, so pointers and views into them survive moving the arena.
+    // The moved-from arena is left empty and allocates fresh blocks of its own.
+    class Arena
+    {
+        public:
+            explicit Arena(size_t p_BlockSize = 64 * 1024);
+
+            Arena(Arena&& p_Other) noexcept;
+            Arena& operator=(Arena&& p_Other) noexcept;
+            Arena(const Arena&) = delete;
+            Arena& operator=(const Arena&) = delete;
+
+            void* Allocate(size_t p_Size, size_t p_Alignment = alignof(std::max_align_t));
+
+            // Copies the text with a NUL after it, so data() can go to C apis as is
+            std::string_view Store(std::string_view p_Text);
+
+            // Keeps the first block for reuse
+            void Reset();
+
+            size_t GetUsed() const { return m_Used; }
+            size_t GetCapacity() const { return m_Capacity; }
+
+        private:
+            struct Block
+            {
+                std::unique_ptr<char[]> Data;
+                size_t Size = 0;
+            };
+
+            char* AddBlock(size_t p_Size, bool p_MakeCurrent);
+
+        private:
+            std::vector<Block> m_Blocks;
+            char* m_Cursor = nullptr;
+            char* m_End = nullptr;
+
+            size_t m_BlockSize;
+            size_t m_Used = 0;
+            size_t m_Capacity = 0;
+    };
+
+} // namespace SCPY
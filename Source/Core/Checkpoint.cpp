@@ -0,0 +1,127 @@
+#include "Checkpoint.h"
+#include "Base.h"
+
+// lib
+#include <yaml-cpp/yaml.h>
+
+// std
+#include <algorithm>
+#include <fstream>
+
+
+
+namespace SCPY
+{
+    void CrawlCheckpoint::MarkCompleted(int p_Page)
+    {
+        auto it = std::lower_bound(Completed.begin(), Completed.end(), p_Page, 
+            [](const std::pair<int, int>& p_Run, int p_Value) { return p_Run.second < p_Value; });
+
+        if (it != Completed.end() && it->first <= p_Page)
+            return;
+
+        // extend a neighbour run, merging both sides when the page closes a gap
+        bool joinsPrev = it != Completed.begin() && std::prev(it)->second == p_Page - 1;
+        bool joinsNext = it != Completed.end() && it->first == p_Page + 1;
+
+        if (joinsPrev && joinsNext)
+        {
+            std::prev(it)->second = it->second;
+            Completed.erase(it);
+        }
+        else if (joinsPrev)
+            std::prev(it)->second = p_Page;
+        else if (joinsNext)
+            it->first = p_Page;
+        else
+            Completed.insert(it, { p_Page, p_Page });
+    }
+
+    bool CrawlCheckpoint::IsCompleted(int p_Page) const
+    {
+        auto it = std::lower_bound(Completed.begin(), Completed.end(), p_Page, 
+            [](const std::pair<int, int>& p_Run, int p_Value) { return p_Run.second < p_Value; });
+
+        return it != Completed.end() && it->first <= p_Page;
+    }
+
+    size_t CrawlCheckpoint::GetCompletedCount() const
+    {
+        size_t count = 0;
+        for (const auto& [first, last] : Completed)
+            count += size_t(last - first + 1);
+        return count;
+    }
+
+    bool CrawlCheckpoint::Save(const std::filesystem::path& p_Path) const
+    {
+        YAML::Emitter out;
+        out << YAML::BeginMap;
+        out << YAML::Key << "Term" << YAML::Value << Term;
+        out << YAML::Key << "DocsPerPage" << YAML::Value << DocsPerPage;
+        out << YAML::Key << "TotalResults" << YAML::Value << TotalResults;
+        out << YAML::Key << "SinkPosition" << YAML::Value << SinkPosition;
+        out << YAML::Key << "RecordCount" << YAML::Value << RecordCount;
+        out << YAML::Key << "Completed" << YAML::Value << YAML::Flow << YAML::BeginSeq;
+        for (const auto& [first, last] : Completed)
+            out << YAML::Flow << YAML::BeginSeq << first << last << YAML::EndSeq;
+        out << YAML::EndSeq;
+        out << YAML::EndMap;
+
+        std::filesystem::path temporary = p_Path;
+        temporary += ".tmp";
+
+        {
+            std::ofstream file(temporary, std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                LOG("ERROR: Failed to write checkpoint {}", temporary.string());
+                return false;
+            }
+
+            file << out.c_str() << '\n';
+            file.flush();
+            if (!file)
+                return false;
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporary, p_Path, error);
+        if (error)
+        {
+            LOG("ERROR: Failed to commit checkpoint {}: {}", p_Path.string(), error.message());
+            return false;
+        }
+
+        return true;
+    }
+
+    std::optional<CrawlCheckpoint> CrawlCheckpoint::Load(const std::filesystem::path& p_Path)
+    {
+        if (!std::filesystem::exists(p_Path))
+            return std::nullopt;
+
+        try
+        {
+            YAML::Node node = YAML::LoadFile(p_Path.string());
+
+            CrawlCheckpoint checkpoint;
+            checkpoint.Term = node["Term"].as<std::string>();
+            checkpoint.DocsPerPage = node["DocsPerPage"].as<int>();
+            checkpoint.TotalResults = node["TotalResults"].as<size_t>();
+            checkpoint.SinkPosition = node["SinkPosition"].as<uint64_t>();
+            checkpoint.RecordCount = node["RecordCount"].as<size_t>();
+
+            for (const auto& run : node["Completed"])
+                checkpoint.Completed.emplace_back(run[0].as<int>(), run[1].as<int>());
+
+            return checkpoint;
+        }
+        catch (const YAML::Exception& e)
+        {
+            LOG("ERROR: Failed to read checkpoint {}: {}", p_Path.string(), e.what());
+            return std::nullopt;
+        }
+    }
+
+} // namespace SCPY
@@ -0,0 +1,37 @@
+#pragma once
+
+// std
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+
+namespace SCPY
+{
+    // Progress of a crawl: which pages made it into the sink and how many bytes of the sink they cover.
+    // Completed pages are kept as sorted, disjoint [first, last] runs, a full harvest is a single run.
+    struct CrawlCheckpoint
+    {
+        std::string Term;
+        int DocsPerPage = 0;
+        size_t TotalResults = 0;
+
+        uint64_t SinkPosition = 0;
+        size_t RecordCount = 0;
+
+        std::vector<std::pair<int, int>> Completed;
+
+        void MarkCompleted(int p_Page);
+        bool IsCompleted(int p_Page) const;
+        size_t GetCompletedCount() const;
+
+        // Written to a temporary next to p_Path and renamed over it, a crash never leaves half a checkpoint
+        bool Save(const std::filesystem::path& p_Path) const;
+        static std::optional<CrawlCheckpoint> Load(const std::filesystem::path& p_Path);
+    };
+
+} // namespace SCPY
@@ -0,0 +1,100 @@
+#include "Corpus.h"
+#include "Base.h"
+
+// std
+#include <bit>
+#include <cstring>
+
+
+
+namespace SCPY
+{
+    static_assert(std::endian::native == std::endian::little, "the corpus is read in place, it needs a little endian host");
+    static_assert(sizeof(CorpusHeader) % 8 == 0);
+
+    namespace
+    {
+        constexpr size_t s_FieldCount = size_t(LawsuitField::Count);
+
+        bool FitsIn(uint64_t p_Offset, uint64_t p_Size, uint64_t p_FileSize)
+        {
+            return p_Offset <= p_FileSize && p_Size <= p_FileSize - p_Offset;
+        }
+
+    } // namespace
+
+    std::unique_ptr<Corpus> Corpus::Open(const std::filesystem::path& p_Path)
+    {
+        std::unique_ptr<Corpus> corpus(new Corpus());
+        if (!corpus->m_File.Open(p_Path))
+            return nullptr;
+
+        const char* data = corpus->m_File.GetData();
+        uint64_t size = corpus->m_File.GetSize();
+
+        const CorpusHeader* header = (const CorpusHeader*)data;
+        if (size < sizeof(CorpusHeader) || std::memcmp(header->Magic, s_CorpusMagic, sizeof(s_CorpusMagic)) != 0)
+        {
+            LOG("ERROR: {} is not a corpus", p_Path.string());
+            return nullptr;
+        }
+
+        if (header->Version != s_CorpusVersion || header->FieldCount != s_FieldCount)
+        {
+            LOG("ERROR: {} is a version {} corpus with {} fields, expected version {} with {}", p_Path.string(), 
+                header->Version, header->FieldCount, s_CorpusVersion, s_FieldCount);
+            return nullptr;
+        }
+
+        bool valid = FitsIn(header->TermOffset, header->TermSize, size)
+            && header->RecordCount <= size / (s_FieldCount * sizeof(uint64_t))
+            && header->IndexOffset % alignof(uint64_t) == 0
+            && FitsIn(header->IndexOffset, header->RecordCount * s_FieldCount * sizeof(uint64_t), size);
+
+        for (size_t i = 0; i < s_FieldCount && valid; i++)
+        {
+            uint64_t blobSize = header->BlobSizes[i];
+            valid = FitsIn(header->BlobOffsets[i], blobSize, size)
+                && (header->RecordCount == 0 || (blobSize > 0 && data[header->BlobOffsets[i] + blobSize - 1] == '\0'));
+        }
+
+        if (!valid)
+        {
+            LOG("ERROR: {} is truncated or corrupt", p_Path.string());
+            return nullptr;
+        }
+
+        corpus->m_Header = header;
+        corpus->m_Index = (const uint64_t*)(data + header->IndexOffset);
+        corpus->m_Term = std::string_view(data + header->TermOffset, header->TermSize);
+        for (size_t i = 0; i < s_FieldCount; i++)
+            corpus->m_Blobs[i] = data + header->BlobOffsets[i];
+
+        return corpus;
+    }
+
+    LawsuitView Corpus::Get(size_t p_Index) const
+    {
+        LawsuitView lawsuit;
+        if (p_Index >= m_Header->RecordCount)
+            return lawsuit;
+
+        const uint64_t* row = m_Index + p_Index * s_FieldCount;
+        bool last = p_Index + 1 == m_Header->RecordCount;
+
+        for (size_t i = 0; i < s_FieldCount; i++)
+        {
+            uint64_t start = row[i];
+            uint64_t end = last ? m_Header->BlobSizes[i] : row[i + s_FieldCount];
+
+            // a bad offset only costs that field, the rest of the corpus stays readable
+            if (start >= end || end > m_Header->BlobSizes[i])
+                continue;
+
+            lawsuit[LawsuitField(i)] = std::string_view(m_Blobs[i] + start, end - start - 1);
+        }
+
+        return lawsuit;
+    }
+
+} // namespace SCPY
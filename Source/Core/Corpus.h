@@ -0,0 +1,60 @@
+#pragma once
+#include "Search.h"
+#include "MappedFile.h"
+
+// std
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+
+
+namespace SCPY
+{
+    // Binary crawl output, little endian:
+    // [CorpusHeader][Term, NUL, padding to 8][Index][one blob per field]
+    // Index row i has the offsets where record i's fields start inside their blobs,
+    // a field ends where the next record's starts (or at the blob's end). Strings keep their NUL.
+    struct CorpusHeader
+    {
+        char Magic[8];
+        uint32_t Version;
+        uint32_t FieldCount;
+        uint64_t RecordCount;
+        uint64_t TotalResults;
+        uint64_t TermOffset;
+        uint64_t TermSize;
+        uint64_t IndexOffset;
+        uint64_t BlobOffsets[size_t(LawsuitField::Count)];
+        uint64_t BlobSizes[size_t(LawsuitField::Count)];
+    };
+
+    inline constexpr char s_CorpusMagic[8] = { 'S', 'C', 'P', 'Y', 'C', 'O', 'R', 'P' };
+    inline constexpr uint32_t s_CorpusVersion = 1;
+
+    // Memory mapped corpus: opening only checks the header, records are decoded when asked for
+    class Corpus
+    {
+        public:
+            static std::unique_ptr<Corpus> Open(const std::filesystem::path& p_Path);
+
+            size_t GetCount() const { return m_Header->RecordCount; }
+            size_t GetTotalResults() const { return m_Header->TotalResults; }
+            std::string_view GetTerm() const { return m_Term; }
+
+            // The views point into the mapping, they live as long as the corpus
+            LawsuitView Get(size_t p_Index) const;
+
+        private:
+            Corpus() = default;
+
+        private:
+            MappedFile m_File;
+            const CorpusHeader* m_Header = nullptr;
+            const uint64_t* m_Index = nullptr;
+            std::string_view m_Term;
+            const char* m_Blobs[size_t(LawsuitField::Count)] = {};
+    };
+
+} // namespace SCPY
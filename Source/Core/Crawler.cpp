@@ -0,0 +1,233 @@
+#include "Crawler.h"
+#include "Base.h"
+#include "Search.h"
+#include "ThreadPool.h"
+#include "Export/LawsuitSink.h"
+
+// std
+#include <map>
+
+
+
+namespace SCPY
+{
+    CrawlJob::CrawlJob(const Search& p_Search, const std::string& p_Term, std::shared_ptr<LawsuitSink> p_Sink, const CrawlOptions& p_Options)
+        : m_Search(p_Search), m_Term(p_Term), m_Sink(std::move(p_Sink)), m_Options(p_Options)
+    {
+        if (m_Options.Workers == 0)
+            m_Options.Workers = 1;
+    }
+
+    CrawlJob::~CrawlJob()
+    {
+        Cancel();
+        Wait();
+    }
+
+    void CrawlJob::Start()
+    {
+        if (m_Thread.joinable()) return;
+
+        m_Thread = std::thread([this]() { Run(); });
+    }
+
+    void CrawlJob::Wait()
+    {
+        if (m_Thread.joinable() && m_Thread.get_id() != std::this_thread::get_id())
+            m_Thread.join();
+    }
+
+    std::vector<DeadLetter> CrawlJob::GetDeadLetters()
+    {
+        std::lock_guard<std::mutex> lock(m_DeadLettersMutex);
+        return m_DeadLetters;
+    }
+
+    void CrawlJob::AddDeadLetter(int p_Page, const std::string& p_Error)
+    {
+        LOG("ERROR: Crawl of '{}' gave up on page {}: {}", m_Term, p_Page, p_Error);
+
+        std::lock_guard<std::mutex> lock(m_DeadLettersMutex);
+        m_DeadLetters.push_back({ p_Page, p_Error });
+        m_FailedPages++;
+    }
+
+    bool CrawlJob::OpenSink(CrawlCheckpoint& p_Checkpoint, size_t p_TotalResults)
+    {
+        if (!m_Options.Checkpoint.empty())
+        {
+            auto saved = CrawlCheckpoint::Load(m_Options.Checkpoint);
+            bool matches = saved && saved->Term == m_Term && saved->DocsPerPage == m_Options.DocsPerPage && saved->TotalResults == p_TotalResults;
+
+            if (matches && m_Sink->Resume(saved->SinkPosition))
+            {
+                LOG("Resuming crawl of '{}': {} pages, {} records already harvested", m_Term, saved->GetCompletedCount(), saved->RecordCount);
+
+                p_Checkpoint = std::move(*saved);
+                m_RecordCount = p_Checkpoint.RecordCount;
+                m_Resumed = true;
+                return true;
+            }
+        }
+
+        p_Checkpoint = {};
+        p_Checkpoint.Term = m_Term;
+        p_Checkpoint.DocsPerPage = m_Options.DocsPerPage;
+        p_Checkpoint.TotalResults = p_TotalResults;
+
+        return m_Sink->Open(m_Term, p_TotalResults);
+    }
+
+    void CrawlJob::SaveCheckpoint(CrawlCheckpoint& p_Checkpoint)
+    {
+        if (m_Options.Checkpoint.empty()) return;
+
+        // the position only covers what the sink has actually pushed out
+        p_Checkpoint.SinkPosition = m_Sink->Flush();
+        p_Checkpoint.RecordCount = m_RecordCount;
+        p_Checkpoint.Save(m_Options.Checkpoint);
+    }
+
+    void CrawlJob::Run()
+    {
+        CancelFn isCancelled = [this]() { return m_Cancelled.load(); };
+        const int docsPerPage = m_Options.DocsPerPage;
+
+        // an interrupted run already knows the result count, keep planning with the same one
+        size_t totalResults = m_Options.TotalResults;
+        if (totalResults == 0 && !m_Options.Checkpoint.empty())
+        {
+            auto saved = CrawlCheckpoint::Load(m_Options.Checkpoint);
+            if (saved && saved->Term == m_Term && saved->DocsPerPage == docsPerPage)
+                totalResults = saved->TotalResults;
+        }
+
+        PagePtr firstPage;
+        if (totalResults == 0)
+        {
+            try
+            {
+                firstPage = m_Search.FetchPage(m_Term, docsPerPage, 0, isCancelled, &m_RetryBudget);
+            }
+            catch (const std::exception& e)
+            {
+                AddDeadLetter(0, e.what());
+            }
+
+            if (!firstPage)
+            {
+                m_Done = true;
+                return;
+            }
+
+            totalResults = firstPage->TotalResults;
+        }
+
+        std::vector<int> pages = m_Options.Pages;
+        if (pages.empty())
+        {
+            int lastPage = int((totalResults + docsPerPage - 1) / docsPerPage);
+            for (int page = 0; page < lastPage; page++)
+                pages.push_back(page);
+        }
+
+        m_TotalResults = totalResults;
+        m_TotalPages = pages.size();
+
+        CrawlCheckpoint checkpoint;
+        if (!OpenSink(checkpoint, totalResults))
+        {
+            m_Done = true;
+            return;
+        }
+
+        std::erase_if(pages, [&checkpoint](int p_Page) { return checkpoint.IsCompleted(p_Page); });
+        m_CompletedPages = m_TotalPages - pages.size();
+
+        ThreadPool workers(m_Options.Workers);
+
+        // pages finish out of order, keep at most a couple per worker waiting for their turn
+        const size_t window = size_t(m_Options.Workers) * 2;
+        std::map<size_t, std::future<PagePtr>> inFlight;
+
+        size_t nextSubmit = 0;
+        size_t nextWrite = 0;
+
+        uint32_t pagesSinceSave = 0;
+        auto lastSave = std::chrono::steady_clock::now();
+
+        while (nextWrite < pages.size() && !isCancelled())
+        {
+            while (nextSubmit < pages.size() && nextSubmit - nextWrite < window)
+            {
+                int page = pages[nextSubmit];
+                if (firstPage && page == 0)
+                {
+                    std::promise<PagePtr> ready;
+                    ready.set_value(firstPage);
+                    inFlight[nextSubmit++] = ready.get_future();
+                    continue;
+                }
+
+                inFlight[nextSubmit++] = workers.Submit([this, page, docsPerPage, isCancelled]()
+                {
+                    return PagePtr(m_Search.FetchPage(m_Term, docsPerPage, page, isCancelled, &m_RetryBudget));
+                });
+            }
+
+            auto it = inFlight.find(nextWrite);
+            PagePtr page;
+            try
+            {
+                page = it->second.get();
+            }
+            catch (const std::exception& e)
+            {
+                AddDeadLetter(pages[nextWrite], e.what());
+            }
+            inFlight.erase(it);
+
+            if (page)
+            {
+                for (const auto& lawsuit : page->Lawsuits)
+                    m_Sink->Write(lawsuit);
+
+                m_RecordCount += page->Lawsuits.size();
+                m_CompletedPages++;
+
+                checkpoint.MarkCompleted(page->Page);
+                pagesSinceSave++;
+            }
+
+            nextWrite++;
+
+            auto now = std::chrono::steady_clock::now();
+            if (pagesSinceSave >= m_Options.CheckpointEveryPages || (pagesSinceSave > 0 && now - lastSave >= m_Options.CheckpointInterval))
+            {
+                SaveCheckpoint(checkpoint);
+                pagesSinceSave = 0;
+                lastSave = now;
+            }
+        }
+
+        firstPage.reset();
+        workers.Clear();
+        inFlight.clear();
+
+        SaveCheckpoint(checkpoint);
+
+        // returns once everything is on disk, a new crawl may reopen the file as soon as m_Done is set
+        m_Sink->Close();
+
+        // a finished harvest has nothing left to resume
+        bool complete = !isCancelled() && m_FailedPages == 0;
+        if (complete && !m_Options.Checkpoint.empty())
+        {
+            std::error_code error;
+            std::filesystem::remove(m_Options.Checkpoint, error);
+        }
+
+        m_Done = true;
+    }
+
+} // namespace SCPY
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Checkpoint.h"
+#include "Net/RetryPolicy.h"
+
+// std
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+
+namespace SCPY
+{
+    class Search;
+    class LawsuitSink;
+
+    struct CrawlOptions
+    {
+        uint32_t Workers = 16;
+        int DocsPerPage = 50;
+
+        // Known result count for the term, 0 fetches the first page before planning the rest
+        size_t TotalResults = 0;
+
+        // Pages to harvest, in order. Empty means every page of the term.
+        std::vector<int> Pages;
+
+        // When set, progress is saved there and a matching checkpoint left by an interrupted
+        // run is picked up: its pages are skipped and the sink appends from the saved position.
+        std::filesystem::path Checkpoint;
+        uint32_t CheckpointEveryPages = 10;
+        std::chrono::seconds CheckpointInterval{ 5 };
+    };
+
+    // A page the crawl gave up on, kept so it can be queued again later
+    struct DeadLetter
+    {
+        int Page = 0;
+        std::string Error;
+    };
+
+    // Harvests every result page of a term on a bounded pool of workers and streams the records,
+    // in page order, to a sink. Only a window of pages proportional to the worker count is held in memory.
+    class CrawlJob
+    {
+        public:
+            CrawlJob(const Search& p_Search, const std::string& p_Term, std::shared_ptr<LawsuitSink> p_Sink, const CrawlOptions& p_Options);
+            ~CrawlJob();
+
+            CrawlJob(const CrawlJob&) = delete;
+            CrawlJob& operator=(const CrawlJob&) = delete;
+
+            void Start();
+            void Cancel() { m_Cancelled = true; }
+            void Wait();
+
+            bool IsDone() const { return m_Done; }
+            bool IsCancelled() const { return m_Cancelled; }
+
+            const std::string& GetTerm() const { return m_Term; }
+            size_t GetTotalResults() const { return m_TotalResults; }
+            size_t GetTotalPages() const { return m_TotalPages; }
+            size_t GetCompletedPages() const { return m_CompletedPages; }
+            size_t GetFailedPages() const { return m_FailedPages; }
+            size_t GetRecordCount() const { return m_RecordCount; }
+            bool IsResumed() const { return m_Resumed; }
+            uint32_t GetRetryCount() const { return m_RetryBudget.GetRetries(); }
+            const CrawlOptions& GetOptions() const { return m_Options; }
+
+            std::vector<DeadLetter> GetDeadLetters();
+
+        private:
+            void Run();
+            void AddDeadLetter(int p_Page, const std::string& p_Error);
+            bool OpenSink(CrawlCheckpoint& p_Checkpoint, size_t p_TotalResults);
+            void SaveCheckpoint(CrawlCheckpoint& p_Checkpoint);
+
+        private:
+            const Search& m_Search;
+            std::string m_Term;
+            std::shared_ptr<LawsuitSink> m_Sink;
+            CrawlOptions m_Options;
+
+            std::atomic<bool> m_Cancelled = false;
+            std::atomic<bool> m_Done = false;
+            std::atomic<bool> m_Resumed = false;
+            std::atomic<size_t> m_TotalResults = 0;
+            std::atomic<size_t> m_TotalPages = 0;
+            std::atomic<size_t> m_CompletedPages = 0;
+            std::atomic<size_t> m_FailedPages = 0;
+            std::atomic<size_t> m_RecordCount = 0;
+
+            RetryBudget m_RetryBudget;
+            std::vector<DeadLetter> m_DeadLetters;
+            std::mutex m_DeadLettersMutex;
+
+            std::thread m_Thread;
+    };
+
+} // namespace SCPY
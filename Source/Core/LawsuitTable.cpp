@@ -0,0 +1,138 @@
+#include "LawsuitTable.h"
+
+// std
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+
+
+namespace SCPY
+{
+    void LawsuitTable::Append(const LawsuitView& p_Lawsuit)
+    {
+        for (size_t i = 0; i < m_Columns.size(); i++)
+        {
+            Column& column = m_Columns[i];
+            std::string_view value = p_Lawsuit[(LawsuitField)i];
+
+            column.Bytes.append(value);
+            column.Bytes.push_back('\0');
+            column.Offsets.push_back(column.Bytes.size());
+        }
+
+        m_Rows++;
+    }
+
+    void LawsuitTable::Append(const SearchPage& p_Page)
+    {
+        for (const auto& lawsuit : p_Page.Lawsuits)
+            Append(lawsuit);
+    }
+
+    void LawsuitTable::Reserve(size_t p_Rows)
+    {
+        for (auto& column : m_Columns)
+            column.Offsets.reserve(p_Rows + 1);
+    }
+
+    void LawsuitTable::Clear()
+    {
+        for (auto& column : m_Columns)
+        {
+            column.Bytes.clear();
+            column.Offsets.assign(1, 0);
+        }
+
+        m_Rows = 0;
+    }
+
+    std::string_view LawsuitTable::Get(size_t p_Row, LawsuitField p_Field) const
+    {
+        const Column& column = m_Columns[(size_t)p_Field];
+        uint64_t begin = column.Offsets[p_Row];
+        uint64_t end = column.Offsets[p_Row + 1] - 1; // without the NUL
+
+        return std::string_view(column.Bytes.data() + begin, end - begin);
+    }
+
+    LawsuitView LawsuitTable::GetRow(size_t p_Row) const
+    {
+        LawsuitView lawsuit;
+        for (size_t i = 0; i < m_Columns.size(); i++)
+            lawsuit[(LawsuitField)i] = Get(p_Row, (LawsuitField)i);
+
+        return lawsuit;
+    }
+
+    std::vector<uint32_t> LawsuitTable::SortBy(LawsuitField p_Field, bool p_Descending) const
+    {
+        std::vector<uint32_t> order(m_Rows);
+        std::iota(order.begin(), order.end(), 0);
+
+        if (p_Field == LawsuitField::JudgmentDate || p_Field == LawsuitField::PubDate)
+        {
+            // parse each date once instead of on every comparison
+            std::vector<uint32_t> keys(m_Rows);
+            for (size_t i = 0; i < m_Rows; i++)
+                keys[i] = ParseDate(Get(i, p_Field));
+
+            std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) 
+            { 
+                return p_Descending ? keys[a] > keys[b] : keys[a] < keys[b]; 
+            });
+        }
+        else
+        {
+            std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) 
+            { 
+                return p_Descending ? Get(a, p_Field) > Get(b, p_Field) : Get(a, p_Field) < Get(b, p_Field); 
+            });
+        }
+
+        return order;
+    }
+
+    std::vector<std::pair<std::string_view, size_t>> LawsuitTable::CountBy(LawsuitField p_Field) const
+    {
+        std::unordered_map<std::string_view, size_t> counts;
+        for (size_t i = 0; i < m_Rows; i++)
+            counts[Get(i, p_Field)]++;
+
+        std::vector<std::pair<std::string_view, size_t>> result(counts.begin(), counts.end());
+        std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) 
+        { 
+            return a.second != b.second ? a.second > b.second : a.first < b.first; 
+        });
+
+        return result;
+    }
+
+    uint32_t LawsuitTable::ParseDate(std::string_view p_Text)
+    {
+        auto digits = [&](size_t p_Start, size_t p_Count)
+        {
+            uint32_t value = 0;
+            for (size_t i = p_Start; i < p_Start + p_Count; i++)
+            {
+                if (p_Text[i] < '0' || p_Text[i] > '9')
+                    return UINT32_MAX;
+                value = value * 10 + (p_Text[i] - '0');
+            }
+            return value;
+        };
+
+        for (size_t i = 0; i + 10 <= p_Text.size(); i++)
+        {
+            if (p_Text[i + 2] != '/' || p_Text[i + 5] != '/')
+                continue;
+
+            uint32_t day = digits(i, 2), month = digits(i + 3, 2), year = digits(i + 6, 4);
+            if (day != UINT32_MAX && month != UINT32_MAX && year != UINT32_MAX)
+                return year * 10000 + month * 100 + day;
+        }
+
+        return 0;
+    }
+
+} // namespace SCPY
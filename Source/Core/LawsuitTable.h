@@ -0,0 +1,56 @@
+#pragma once
+#include "Search.h"
+
+// std
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+
+namespace SCPY
+{
+    // Struct-of-arrays result set: every field is one contiguous byte column plus its offsets,
+    // so a sort or a count over one field never pulls the others through the cache.
+    class LawsuitTable
+    {
+        public:
+            LawsuitTable() = default;
+
+            void Append(const LawsuitView& p_Lawsuit);
+            void Append(const SearchPage& p_Page);
+            void Reserve(size_t p_Rows);
+            void Clear();
+
+            // NUL terminated, valid until the column grows
+            std::string_view Get(size_t p_Row, LawsuitField p_Field) const;
+            LawsuitView GetRow(size_t p_Row) const;
+
+            // Row order sorted by one column. Date columns compare by the first dd/mm/yyyy they contain
+            std::vector<uint32_t> SortBy(LawsuitField p_Field, bool p_Descending = false) const;
+
+            // Distinct values of one column with how many rows have each, most frequent first
+            std::vector<std::pair<std::string_view, size_t>> CountBy(LawsuitField p_Field) const;
+
+            size_t GetRowCount() const { return m_Rows; }
+            size_t GetColumnSize(LawsuitField p_Field) const { return m_Columns[(size_t)p_Field].Bytes.size(); }
+
+            // "18/03/2025" -> 20250318, 0 when there is no date
+            static uint32_t ParseDate(std::string_view p_Text);
+
+        private:
+            struct Column
+            {
+                std::string Bytes;
+                std::vector<uint64_t> Offsets = { 0 };
+            };
+
+        private:
+            std::array<Column, (size_t)LawsuitField::Count> m_Columns;
+            size_t m_Rows = 0;
+    };
+
+} // namespace SCPY
@@ -0,0 +1,132 @@
+#include "MappedFile.h"
+#include "Base.h"
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+// std
+#include <utility>
+
+
+
+namespace SCPY
+{
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+    MappedFile::MappedFile(MappedFile&& p_Other) noexcept
+    {
+        *this = std::move(p_Other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& p_Other) noexcept
+    {
+        if (this != &p_Other)
+        {
+            Close();
+            m_Data = std::exchange(p_Other.m_Data, nullptr);
+            m_Size = std::exchange(p_Other.m_Size, 0);
+        #ifdef _WIN32
+            m_File = std::exchange(p_Other.m_File, nullptr);
+            m_Mapping = std::exchange(p_Other.m_Mapping, nullptr);
+        #endif
+        }
+        return *this;
+    }
+
+    bool MappedFile::Open(const std::filesystem::path& p_Path)
+    {
+        Close();
+
+    #ifdef _WIN32
+        HANDLE file = CreateFileW(p_Path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            LOG("ERROR: Failed to open {}", p_Path.string());
+            return false;
+        }
+
+        LARGE_INTEGER size = {};
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!data)
+        {
+            LOG("ERROR: Failed to map {}", p_Path.string());
+            if (mapping)
+                CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+
+        m_File = file;
+        m_Mapping = mapping;
+        m_Data = (const char*)data;
+        m_Size = (size_t)size.QuadPart;
+    #else
+        int file = ::open(p_Path.c_str(), O_RDONLY);
+        if (file < 0)
+        {
+            LOG("ERROR: Failed to open {}", p_Path.string());
+            return false;
+        }
+
+        struct stat info = {};
+        if (fstat(file, &info) != 0 || info.st_size == 0)
+        {
+            ::close(file);
+            return false;
+        }
+
+        void* data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, file, 0);
+
+        // the mapping keeps the file alive on its own
+        ::close(file);
+        if (data == MAP_FAILED)
+        {
+            LOG("ERROR: Failed to map {}", p_Path.string());
+            return false;
+        }
+
+        m_Data = (const char*)data;
+        m_Size = (size_t)info.st_size;
+    #endif
+
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (!m_Data)
+            return;
+
+    #ifdef _WIN32
+        UnmapViewOfFile(m_Data);
+        CloseHandle(m_Mapping);
+        CloseHandle(m_File);
+        m_File = nullptr;
+        m_Mapping = nullptr;
+    #else
+        munmap((void*)m_Data, m_Size);
+    #endif
+
+        m_Data = nullptr;
+        m_Size = 0;
+    }
+
+} // namespace SCPY
@@ -0,0 +1,41 @@
+#pragma once
+
+// std
+#include <cstddef>
+#include <filesystem>
+
+
+
+namespace SCPY
+{
+    // Read only view of a whole file, the OS pages it in as it is touched
+    class MappedFile
+    {
+        public:
+            MappedFile() = default;
+            ~MappedFile();
+
+            MappedFile(MappedFile&& p_Other) noexcept;
+            MappedFile& operator=(MappedFile&& p_Other) noexcept;
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            // Fails on empty files, there is nothing to map
+            bool Open(const std::filesystem::path& p_Path);
+            void Close();
+
+            bool IsOpen() const { return m_Data != nullptr; }
+            const char* GetData() const { return m_Data; }
+            size_t GetSize() const { return m_Size; }
+
+        private:
+            const char* m_Data = nullptr;
+            size_t m_Size = 0;
+
+        #ifdef _WIN32
+            void* m_File = nullptr;
+            void* m_Mapping = nullptr;
+        #endif
+    };
+
+} // namespace SCPY
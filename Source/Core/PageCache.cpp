@@ -0,0 +1,110 @@
+#include "PageCache.h"
+#include "Search.h"
+
+
+
+namespace SCPY
+{
+    size_t PageKeyHash::operator()(const PageKey& p_Key) const
+    {
+        size_t hash = std::hash<std::string>{}(p_Key.Term);
+        hash ^= std::hash<int>{}(p_Key.DocsPerPage) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+        hash ^= std::hash<int>{}(p_Key.Page) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+        return hash;
+    }
+
+    PageCache::PageCache(size_t p_BudgetBytes)
+        : m_Budget(p_BudgetBytes)
+    {
+    }
+
+    std::shared_ptr<const SearchPage> PageCache::Get(const PageKey& p_Key)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto it = m_Index.find(p_Key);
+        if (it == m_Index.end())
+            return nullptr;
+
+        m_Entries.splice(m_Entries.begin(), m_Entries, it->second);
+        return it->second->Page;
+    }
+
+    void PageCache::Put(const PageKey& p_Key, std::shared_ptr<const SearchPage> p_Page)
+    {
+        if (!p_Page) return;
+
+        size_t size = EstimateSize(*p_Page);
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto it = m_Index.find(p_Key);
+        if (it != m_Index.end())
+        {
+            m_Size -= it->second->Size;
+            m_Entries.erase(it->second);
+            m_Index.erase(it);
+        }
+
+        m_Entries.push_front({ p_Key, std::move(p_Page), size });
+        m_Index[p_Key] = m_Entries.begin();
+        m_Size += size;
+
+        EvictLocked();
+    }
+
+    bool PageCache::Contains(const PageKey& p_Key)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Index.find(p_Key) != m_Index.end();
+    }
+
+    void PageCache::Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Entries.clear();
+        m_Index.clear();
+        m_Size = 0;
+    }
+
+    void PageCache::SetBudget(size_t p_BudgetBytes)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Budget = p_BudgetBytes;
+        EvictLocked();
+    }
+
+    size_t PageCache::GetBudget()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Budget;
+    }
+
+    size_t PageCache::GetSize()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Size;
+    }
+
+    size_t PageCache::EstimateSize(const SearchPage& p_Page)
+    {
+        size_t size = sizeof(SearchPage) + p_Page.Term.capacity();
+        size += p_Page.Lawsuits.capacity() * sizeof(LawsuitView);
+        size += p_Page.Text.GetCapacity();
+
+        return size;
+    }
+
+    void PageCache::EvictLocked()
+    {
+        // the page that was just inserted always stays, even if it alone is over budget
+        while (m_Size > m_Budget && m_Entries.size() > 1)
+        {
+            auto& last = m_Entries.back();
+            m_Size -= last.Size;
+            m_Index.erase(last.Key);
+            m_Entries.pop_back();
+        }
+    }
+
+} // namespace SCPY
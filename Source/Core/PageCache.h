@@ -0,0 +1,68 @@
+#pragma once
+
+// std
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+
+
+namespace SCPY
+{
+    struct SearchPage;
+
+    struct PageKey
+    {
+        std::string Term;
+        int DocsPerPage = 0;
+        int Page = 0;
+
+        bool operator==(const PageKey& p_Other) const = default;
+    };
+
+    struct PageKeyHash
+    {
+        size_t operator()(const PageKey& p_Key) const;
+    };
+
+    // Thread safe LRU of parsed result pages, bounded by an estimate of their heap footprint
+    class PageCache
+    {
+        public:
+            explicit PageCache(size_t p_BudgetBytes = 64ull * 1024 * 1024);
+
+            std::shared_ptr<const SearchPage> Get(const PageKey& p_Key);
+            void Put(const PageKey& p_Key, std::shared_ptr<const SearchPage> p_Page);
+            bool Contains(const PageKey& p_Key);
+            void Clear();
+
+            void SetBudget(size_t p_BudgetBytes);
+            size_t GetBudget();
+            size_t GetSize();
+
+            static size_t EstimateSize(const SearchPage& p_Page);
+
+        private:
+            void EvictLocked();
+
+        private:
+            struct Entry
+            {
+                PageKey Key;
+                std::shared_ptr<const SearchPage> Page;
+                size_t Size = 0;
+            };
+
+            // front is the most recently used
+            std::list<Entry> m_Entries;
+            std::unordered_map<PageKey, std::list<Entry>::iterator, PageKeyHash> m_Index;
+
+            size_t m_Budget = 0;
+            size_t m_Size = 0;
+            std::mutex m_Mutex;
+    };
+
+} // namespace SCPY
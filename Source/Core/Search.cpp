@@ -1,59 +1,23 @@
 #include "Search.h"
 #include "Base.h"
+#include "ThreadPool.h"
+#include "Crawler.h"
+#include "Net/HttpCache.h"
+#include "Net/SessionPool.h"
+#include "Net/RateLimiter.h"
+#include "Net/ConcurrencyLimiter.h"
+#include "Net/FetchError.h"
+#include "Parse/HtmlParser.h"
+#include "Parse/ExtractionSchema.h"
+#include "Export/ExportFormat.h"
 
 // lib
 #include <cpr/cpr.h>
-#include <lexbor/html/html.h>
-#include <lexbor/url/url.h>
 #include <yaml-cpp/yaml.h>
-#include <utf8.h>
-
-#ifdef _WIN32
-    #include <windows.h>
-    std::string ConvertEncoding(const std::string& p_Input) 
-    {
-        int required_size = MultiByteToWideChar(CP_ACP, 0, p_Input.c_str(), -1, nullptr, 0);
-        
-        std::wstring wstr(required_size, 0);
-        MultiByteToWideChar(CP_ACP, 0, p_Input.c_str(), -1, &wstr[0], required_size);
-        
-        required_size = WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), -1, nullptr, 0, nullptr, nullptr);
-        
-        std::string result(required_size, 0);
-        WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), -1, &result[0], required_size, nullptr, nullptr);
-        
-        return result;
-    }
-#else // UNTESTED!
-    #include <iconv.h>
-    std::string ConvertEncoding(const std::string& p_Input, const char* p_ToEncoding, const char* p_FromEncoding) 
-    {
-        iconv_t converter = iconv_open(p_ToEncoding, p_FromEncoding);
-        if (converter == (iconv_t)-1) 
-        {
-            LOG("ERROR: Encoding conversion failed");
-            return "";
-        }
-        
-        size_t in_bytes = p_Input.size();
-        char* in_ptr = const_cast<char*>(p_Input.data());
-        size_t out_bytes = in_bytes * 4;
-        std::string output(out_bytes, 0);
-        char* out_ptr = &output[0];
-        
-        if (iconv(converter, &in_ptr, &in_bytes, &out_ptr, &out_bytes) == (size_t)-1) 
-        {
-            iconv_close(converter);
-            LOG("ERROR: Conversion error");
-            return "";
-        }
-        
-        iconv_close(converter);
-        output.resize(output.size() - out_bytes);
-        return output;
-    }
-#endif
 
+// std
+#include <fstream>
+#include <thread>
 
 
 
@@ -61,371 +25,560 @@ namespace SCPY
 {
     namespace 
     {
-        std::string SanitizeUTF8(const std::string& p_Input, char p_Replacement = ' ') 
+        bool FeedCached(const CachedResponse& p_Entry, HtmlParser& p_Parser)
         {
-            std::string output;
-            output.reserve(p_Input.size());
-            
-            auto end_it = utf8::find_invalid(p_Input.begin(), p_Input.end());     
-            if (end_it != p_Input.end()) 
-            {
-                output.append(p_Input.begin(), end_it);
-                output.push_back(p_Replacement);
+            if (!p_Parser.Begin())
+                return false;
 
-                auto it = end_it;
-                while (it != p_Input.end()) 
-                {
-                    try {
-                        utf8::next(it, p_Input.end());
-                        output.append(end_it+1, it);
-                        end_it = it;
-                    } catch (...) {
-                        output.push_back(p_Replacement);
-                        ++it;
-                        end_it = it;
-                    }
-                }
-            } 
-            else 
-            {
-                output = p_Input;
-            }
-            
-            return output;
-        }
+            auto contentType = p_Entry.Header.find("Content-Type");
+            if (contentType != p_Entry.Header.end())
+                p_Parser.SetContentType(contentType->second);
 
-        std::string AutoFixBrokenEncoding(const std::string& p_Input)
-        {
-            if (utf8::is_valid(p_Input.begin(), p_Input.end())) {
-                return p_Input;
-            }
+            return p_Parser.Feed(p_Entry.Body);
+        }
 
-            #ifdef _WIN32
-                std::string converted = ConvertEncoding(p_Input);
-                if (utf8::is_valid(converted.begin(), converted.end())) 
-                    return converted;
-            #else
-                const std::vector<std::string> encodings_to_try = {
-                    "ISO-8859-1",  // Latin-1
-                    "Windows-1252", // Western European
-                    "ISO-8859-15"   // Latin-9
-                };
-
-                for (const auto& encoding : encodings_to_try) 
-                {
-                    std::string converted = ConvertEncoding(input, "UTF-8", encoding);
-                    if (!converted.empty() && utf8::is_valid(converted.begin(), converted.end())) 
-                        return converted;
-                }
-            #endif
+    } // namespace
 
-            return SanitizeUTF8(p_Input);
-        }
+    Search::Search()
+    {
+        m_Executor = std::make_unique<ThreadPool>(2);
+        m_Exporter = std::make_unique<ThreadPool>(1);
+        m_HttpCache = std::make_shared<HttpCache>("Cache/Http", std::chrono::hours(1));
+        m_Sessions = std::make_shared<SessionPool>(cpr::Header{
+            {"User-Agent", "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36"},
+            {"Accept", "text/html,application/xhtml+xml,application/xml;q=0.9,image/webp,*/*;q=0.8"},
+            {"Accept-Language", "pt-BR,pt;q=0.9,en-US;q=0.8,en;q=0.7"},
+            {"Referer", "https://scon.stj.jus.br/"},
+            {"Connection", "keep-alive"}
+        });
+        m_RateLimiter = std::make_shared<RateLimiter>(4.0, 8.0);
+        m_Concurrency = std::make_shared<ConcurrencyLimiter>(1, 16, 2);
+        m_Schema = ExtractionSchema::GetDefault();
+        m_Sessions->SetTimeouts(m_RetryPolicy.ConnectTimeout, m_RetryPolicy.Timeout);
+    }
 
-        lxb_dom_collection_t* MakeCollection(lxb_dom_document_t* p_Document, lxb_dom_element_t* p_Parent, const std::string& p_ClassName)
+    Search::~Search()
+    {
+        for (auto& crawl : m_Crawls)
         {
-            lxb_dom_collection_t* collection = lxb_dom_collection_make(p_Document, 128);
-            
-            lxb_status_t status = lxb_dom_elements_by_class_name(
-                p_Parent, 
-                collection, 
-                reinterpret_cast<const lxb_char_t*>(p_ClassName.c_str()), 
-                p_ClassName.length());
-            
-            if (status != LXB_STATUS_OK) 
+            if (auto job = crawl.lock())
             {
-                lxb_dom_collection_destroy(collection, true);
-                return nullptr;
+                job->Cancel();
+                job->Wait();
             }
-            
-            return collection;
         }
 
-        std::string GetElementText(lxb_dom_element_t* p_Element) 
-        {
-            lxb_dom_node_t* node = lxb_dom_interface_node(p_Element);
-            size_t len;
-            const lxb_char_t* text = lxb_dom_node_text_content(node, &len);
-            auto str = std::string((const char*)text, len);
-            return AutoFixBrokenEncoding(str);
-        }
+        // exports queue behind each other, the last one finishing means all of them did
+        if (m_Export.valid())
+            m_Export.wait();
 
-        std::string GetElementAttribute(lxb_dom_element_t* p_Element, const char* p_Attr) 
-        {
-            size_t len;
-            const lxb_char_t* value = lxb_dom_element_get_attribute(
-                p_Element, (const lxb_char_t*)p_Attr, strlen(p_Attr), &len);
-            return value ? std::string((const char*)value, len) : "";
-        }
+        // cancel whatever is in flight before joining the workers
+        m_Generation++;
+        m_Executor.reset();
+    }
 
-        std::string FormatUrl(const std::string& p_Term, int p_DocsPerPage, int p_CurrentPage = 0, bool p_IsHomePage = true)
-        {
-            std::string search = p_Term;
-            std::replace(search.begin(), search.end(), ' ', '+');
-
-            std::string url = "";
-            
-            if (p_IsHomePage)
-                url = std::format("https://scon.stj.jus.br/SCON/pesquisar.jsp?pesquisaAmigavel=+{0}&b=ACOR&tp=T&numDocsPagina={1}&i=1&O=&ref=&processo=&ementa=&nota=&filtroPorNota=&orgao=&relator=&uf=&classe=&juizo=&data=&dtpb=&dtde=&operador=e&thesaurus=JURIDICO&p=true&livre={0}", search, p_DocsPerPage);
-            else
-            {
-                std::string searchUpper = search;
-                std::transform(searchUpper.begin(), searchUpper.end(), searchUpper.begin(), ::toupper);
+    void Search::SearchTerm(const std::string &p_Term)
+    {
+        m_Term = p_Term;
+        RequestPage(0);
+    }
 
-                url = std::format("https://scon.stj.jus.br/SCON/jurisprudencia/toc.jsp?numDocsPagina={2}&tipo_visualizacao=&filtroPorNota=&ref=&data=&p=true&b=ACOR&pesquisaAmigavel=+{0}&thesaurus=JURIDICO&i={3}&l={2}&tp=T&operador=e&livre={1}&b=ACOR", search, searchUpper, p_DocsPerPage, (p_DocsPerPage * p_CurrentPage) + 1);
-            }
+    void Search::FirstPage()
+    {
+        RequestPage(0);
+    }
 
-            return url;
-        }
+    void Search::NextPage()
+    {
+        RequestPage(HasNextPage() ? m_TargetPage + 1 : m_TargetPage);
+    }
 
-        std::string Clean(const std::string& p_Text)
-        {
-            std::string newText = p_Text;
-            newText.erase(std::remove_if(newText.begin(), newText.end(), [](char c) 
-            {
-                return c == '\n' || c == '\t' || c == '\r';
-            }), newText.end());
+    void Search::PrevPage()
+    {
+        RequestPage(HasPrevPage() ? m_TargetPage - 1 : 0);
+    }
 
-            newText.erase(std::unique(newText.begin(), newText.end(), [](char a, char b) {
-                return a == ' ' && b == ' ';
-            }), newText.end());
+    void Search::LastPage()
+    {
+        if (m_TotalResults == 0) return;
 
-            auto pos = newText.find((char)0);
-            if (pos != std::string::npos)
-                newText.erase(pos);
+        RequestPage(GetLastPage());
+    }
 
-            return newText;
-        }
+    void Search::RequestPage(int p_Page)
+    {
+        m_TargetPage = p_Page;
 
-        std::u32string Utf8ToU32(const std::string& p_Text)
+        if (!m_DeferredLoad)
+            Load();
+    }
+
+    void Search::Load()
+    {
+        if (m_Term.empty()) return;
+
+        PageKey query = { m_Term, m_DocsPerPage, 0 };
+        if (query != m_Query)
         {
-            std::vector<uint32_t> utf32result;
-            auto ptr = p_Text.c_str();
-            utf8::utf8to32(ptr, ptr + p_Text.size(), std::back_inserter(utf32result));
+            // a different query, nothing queued or in flight is useful anymore
+            m_Query = query;
+            m_Generation++;
+            m_Executor->Clear();
 
-            return std::u32string((char32_t*)utf32result.data(), utf32result.size());
+            std::lock_guard<std::mutex> lock(m_InFlightMutex);
+            m_InFlight.clear();
         }
 
-        std::string U32ToUtf8(const std::u32string& p_Text)
+        PageKey key = { m_Term, m_DocsPerPage, m_TargetPage };
+        if (PagePtr page = m_PageCache.Get(key))
         {
-            std::vector<unsigned char> utf8result;
-            auto ptr = p_Text.c_str();
-            utf8::utf32to8(ptr, ptr + p_Text.size(), std::back_inserter(utf8result));
-
-            return std::string((char*)utf8result.data(), utf8result.size());
+            m_Pending = {};
+            Publish(page);
+            return;
         }
 
-    } // namespace
+        m_Pending = FetchAsync(key, true);
+    }
 
-    void Search::SearchTerm(const std::string &p_Term)
+    void Search::SetRateLimit(double p_RequestsPerSecond, double p_Burst)
     {
-        m_Term = p_Term;
-        m_CurrentPage = 0;
-        m_CurrentUrl = FormatUrl(p_Term, m_DocsPerPage);
+        m_RateLimiter->SetRate(p_RequestsPerSecond, p_Burst);
+    }
 
-        if (!m_DeferredLoad)
-            Load();
+    void Search::SetConcurrencyBounds(uint32_t p_Min, uint32_t p_Max)
+    {
+        m_Concurrency->SetBounds(p_Min, p_Max);
+    }
 
-        m_HasPrevPage = false;
-        m_HasNextPage = m_TotalResults > m_DocsPerPage;
+    void Search::SetRetryPolicy(const RetryPolicy& p_Policy)
+    {
+        m_RetryPolicy = p_Policy;
+        m_Sessions->SetTimeouts(m_RetryPolicy.ConnectTimeout, m_RetryPolicy.Timeout);
     }
 
-    void Search::FirstPage()
+    void Search::SetSchema(std::shared_ptr<const ExtractionSchema> p_Schema)
     {
-        m_CurrentUrl = FormatUrl(m_Term, m_DocsPerPage);
-        
-        if (!m_DeferredLoad)
-            Load(); 
+        if (!p_Schema) return;
 
-        m_CurrentPage = 0;
-        m_HasPrevPage = false;
-        m_HasNextPage = m_TotalResults > m_DocsPerPage;
+        {
+            std::lock_guard<std::mutex> lock(m_SchemaMutex);
+            m_Schema = std::move(p_Schema);
+        }
+        m_PageCache.Clear();
     }
 
-    void Search::NextPage()
+    std::shared_ptr<const ExtractionSchema> Search::GetSchema() const
     {
-        if (m_HasNextPage)
-            m_CurrentPage++;
+        std::lock_guard<std::mutex> lock(m_SchemaMutex);
+        return m_Schema;
+    }
 
-        m_CurrentUrl = FormatUrl(m_Term, m_DocsPerPage, m_CurrentPage, false);
+    bool Search::LoadConfig(const std::filesystem::path& p_Path)
+    {
+        if (!std::filesystem::exists(p_Path))
+            return false;
 
-        if (!m_DeferredLoad)
-            Load();
+        try
+        {
+            YAML::Node config = YAML::LoadFile(p_Path.string());
 
-        m_HasPrevPage = true;
-        m_HasNextPage = m_CurrentPage < (m_TotalResults / m_DocsPerPage) - 1;
+            if (YAML::Node search = config["Search"])
+            {
+                if (search["DocsPerPage"])
+                    SetDocsPerPage(search["DocsPerPage"].as<int>());
+                if (search["DeferredLoad"])
+                    SetDeferredLoad(search["DeferredLoad"].as<bool>());
+                if (search["PageCacheBudget"])
+                    SetPageCacheBudget(search["PageCacheBudget"].as<size_t>());
+
+                SetPrefetchWindow(search["PrefetchAhead"].as<int>(m_PrefetchAhead), search["PrefetchBehind"].as<int>(m_PrefetchBehind));
+                SetRateLimit(search["RateLimit"].as<double>(m_RateLimiter->GetRate()), search["RateBurst"].as<double>(m_RateLimiter->GetBurst()));
+                SetConcurrencyBounds(search["MinConcurrency"].as<uint32_t>(m_Concurrency->GetMin()), search["MaxConcurrency"].as<uint32_t>(m_Concurrency->GetMax()));
+
+                if (YAML::Node retry = search["Retry"])
+                {
+                    // in milliseconds
+                    auto read = [&](const char* p_Key, std::chrono::milliseconds& p_Value)
+                    {
+                        p_Value = std::chrono::milliseconds(retry[p_Key].as<int64_t>(p_Value.count()));
+                    };
+
+                    RetryPolicy policy = m_RetryPolicy;
+                    policy.MaxAttempts = retry["MaxAttempts"].as<uint32_t>(policy.MaxAttempts);
+                    read("BaseDelay", policy.BaseDelay);
+                    read("MaxDelay", policy.MaxDelay);
+                    read("ConnectTimeout", policy.ConnectTimeout);
+                    read("Timeout", policy.Timeout);
+                    SetRetryPolicy(policy);
+                }
+            }
+
+            if (YAML::Node node = config["Schema"])
+            {
+                auto schema = ExtractionSchema::Read(node);
+                if (!schema)
+                {
+                    LOG("ERROR: Keeping the current extraction schema, the one in {} is invalid", p_Path.string());
+                    return false;
+                }
+
+                SetSchema(std::make_shared<const ExtractionSchema>(std::move(*schema)));
+            }
+
+            return true;
+        }
+        catch (const YAML::Exception& e)
+        {
+            LOG("ERROR: Failed to read config {}: {}", p_Path.string(), e.what());
+            return false;
+        }
     }
 
-    void Search::PrevPage()
+    bool Search::SaveConfig(const std::filesystem::path& p_Path)
     {
-        if (m_HasPrevPage && m_CurrentPage > 0)
-            m_CurrentPage--;
+        YAML::Emitter out;
+        out << YAML::BeginMap;
 
-        m_CurrentUrl = FormatUrl(m_Term, m_DocsPerPage, m_CurrentPage, m_CurrentPage == 0);
+        out << YAML::Key << "Search" << YAML::Value << YAML::BeginMap;
+        out << YAML::Key << "DocsPerPage" << YAML::Value << m_DocsPerPage;
+        out << YAML::Key << "DeferredLoad" << YAML::Value << m_DeferredLoad;
+        out << YAML::Key << "PrefetchAhead" << YAML::Value << m_PrefetchAhead;
+        out << YAML::Key << "PrefetchBehind" << YAML::Value << m_PrefetchBehind;
+        out << YAML::Key << "PageCacheBudget" << YAML::Value << m_PageCache.GetBudget();
+        out << YAML::Key << "RateLimit" << YAML::Value << m_RateLimiter->GetRate();
+        out << YAML::Key << "RateBurst" << YAML::Value << m_RateLimiter->GetBurst();
+        out << YAML::Key << "MinConcurrency" << YAML::Value << m_Concurrency->GetMin();
+        out << YAML::Key << "MaxConcurrency" << YAML::Value << m_Concurrency->GetMax();
+
+        out << YAML::Key << "Retry" << YAML::Value << YAML::BeginMap;
+        out << YAML::Key << "MaxAttempts" << YAML::Value << m_RetryPolicy.MaxAttempts;
+        out << YAML::Key << "BaseDelay" << YAML::Value << m_RetryPolicy.BaseDelay.count();
+        out << YAML::Key << "MaxDelay" << YAML::Value << m_RetryPolicy.MaxDelay.count();
+        out << YAML::Key << "ConnectTimeout" << YAML::Value << m_RetryPolicy.ConnectTimeout.count();
+        out << YAML::Key << "Timeout" << YAML::Value << m_RetryPolicy.Timeout.count();
+        out << YAML::EndMap;
 
-        if (!m_DeferredLoad)
-            Load();
+        out << YAML::EndMap;
+
+        out << YAML::Key << "Schema" << YAML::Value;
+        GetSchema()->Write(out);
 
-        m_HasNextPage = true;
-        m_HasPrevPage = m_CurrentPage > 0;
+        out << YAML::EndMap;
+
+        std::ofstream file(p_Path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            LOG("ERROR: Failed to write config {}", p_Path.string());
+            return false;
+        }
+
+        file << out.c_str() << '\n';
+        return bool(file);
     }
 
-    void Search::LastPage()
+    std::shared_ptr<CrawlJob> Search::Crawl(const std::string& p_Term, std::shared_ptr<LawsuitSink> p_Sink, CrawlOptions p_Options)
     {
-        m_CurrentPage = int(m_TotalResults / m_DocsPerPage);
+        p_Options.DocsPerPage = m_DocsPerPage;
 
-        m_CurrentUrl = FormatUrl(m_Term, m_DocsPerPage, m_CurrentPage, false);
+        if (m_Page && m_Page->Term == p_Term && m_Page->DocsPerPage == m_DocsPerPage)
+            p_Options.TotalResults = m_TotalResults;
 
-        if (!m_DeferredLoad)
-            Load();
+        return StartCrawl(p_Term, std::move(p_Sink), p_Options);
+    }
+
+    std::shared_ptr<CrawlJob> Search::Recrawl(CrawlJob& p_Failed, std::shared_ptr<LawsuitSink> p_Sink)
+    {
+        auto deadLetters = p_Failed.GetDeadLetters();
+        if (deadLetters.empty())
+            return nullptr;
+
+        CrawlOptions options = p_Failed.GetOptions();
+        options.TotalResults = p_Failed.GetTotalResults();
+
+        // dead pages never make it into the checkpoint, resuming picks exactly those up
+        if (options.Checkpoint.empty())
+        {
+            options.Pages.clear();
+            for (const auto& letter : deadLetters)
+                options.Pages.push_back(letter.Page);
+
+            std::sort(options.Pages.begin(), options.Pages.end());
+        }
 
-        m_HasPrevPage = true;
-        m_HasNextPage = false;
+        return StartCrawl(p_Failed.GetTerm(), std::move(p_Sink), options);
     }
 
-    void Search::Load()
+    std::shared_ptr<CrawlJob> Search::StartCrawl(const std::string& p_Term, std::shared_ptr<LawsuitSink> p_Sink, const CrawlOptions& p_Options)
     {
-        if (m_Term.empty() && m_CurrentUrl.empty()) return;
+        std::erase_if(m_Crawls, [](const std::weak_ptr<CrawlJob>& p_Job) { return p_Job.expired(); });
+
+        auto job = std::make_shared<CrawlJob>(*this, p_Term, std::move(p_Sink), p_Options);
+        m_Crawls.push_back(job);
+        job->Start();
 
-        FetchAndParseHtml(m_CurrentUrl.empty() ? FormatUrl(m_Term, m_DocsPerPage) : m_CurrentUrl); 
+        return job;
     }
 
-    void Search::ExportYML()
+    bool Search::Update()
     {
-        YAML::Emitter out;
-        out << YAML::BeginMap;
-        out << YAML::Key << "Term" << YAML::Value << m_Term;
-        out << YAML::Key << "Lawsuits" << YAML::Value << YAML::BeginSeq;
-        
-        for (auto& lawsuit : m_Lawsuits)
+        if (!m_Pending.valid() || m_Pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return false;
+
+        PagePtr page;
+        try
+        {
+            page = m_Pending.get();
+            m_LastError.clear();
+        }
+        catch (const std::exception& e)
         {
-            out << YAML::BeginMap;
-            out << YAML::Key << "Case" << YAML::Value << lawsuit.Case;
-            out << YAML::Key << "Rapporteur" << YAML::Value << lawsuit.Rapporteur;
-            out << YAML::Key << "JudgmentDate" << YAML::Value << lawsuit.JudgmentDate;
-            out << YAML::Key << "PubDate" << YAML::Value << lawsuit.PubDate;
-            out << YAML::Key << "Headnote" << YAML::Value << lawsuit.Headnote;
-            out << YAML::Key << "Decision" << YAML::Value << lawsuit.Decision;
-            out << YAML::EndMap;
+            LOG("ERROR: Search request failed: {}", e.what());
+            m_LastError = e.what();
         }
+        m_Pending = {};
 
-        out << YAML::EndSeq;
-        out << YAML::EndMap;
+        if (!page) return false;
 
-        std::string term = m_Term;
-        std::replace(term.begin(), term.end(), ' ', '-');
-        std::ofstream fout("Search-" + term + ".yml");
-        fout << out.c_str();
+        Publish(page);
+        return true;
     }
 
-    void Search::ParseHtml(const std::string &p_Html)
+    const std::vector<LawsuitView>& Search::GetLawsuits() const
     {
-        lxb_html_document_t* document = lxb_html_document_create();
-        lxb_html_document_parse(document, reinterpret_cast<const lxb_char_t*>(p_Html.c_str()), p_Html.length());
-        
-        lxb_dom_collection_t* resultCounters = MakeCollection(&document->dom_document, lxb_dom_interface_element(document->body), "numDocs");
-        
-        if (resultCounters && lxb_dom_collection_length(resultCounters) > 0)
+        static const std::vector<LawsuitView> s_Empty;
+        return m_Page ? m_Page->Lawsuits : s_Empty;
+    }
+
+    void Search::Publish(const PagePtr& p_Page)
+    {
+        // toc pages may omit the counter, keep the one from the first page
+        if (p_Page->TotalResults > 0 || p_Page->Page == 0)
+            m_TotalResults = p_Page->TotalResults;
+
+        m_CurrentPage = p_Page->Page;
+        m_Page = p_Page;
+
+        Prefetch(m_CurrentPage);
+    }
+
+    void Search::Prefetch(int p_Page)
+    {
+        int lastPage = GetLastPage();
+        int reach = std::max(m_PrefetchAhead, m_PrefetchBehind);
+
+        // nearest pages first, so the likely next click is fetched before the rest of the window
+        for (int distance = 1; distance <= reach; distance++)
         {
-            lxb_dom_element_t* counterElement = lxb_dom_collection_element(resultCounters, 0);
-            std::string counterText = GetElementText(counterElement);
-            
-            // (ex: "15.575 acórdãos" -> 15575)
-            counterText.erase(std::remove_if(counterText.begin(), counterText.end(), 
-                [](char c) { return c < -1 ? true : !std::isdigit(c); }), counterText.end());
-                
-            m_TotalResults = std::stoul(counterText);
+            if (distance <= m_PrefetchAhead && p_Page + distance <= lastPage)
+            {
+                PageKey key = { m_Term, m_DocsPerPage, p_Page + distance };
+                if (!m_PageCache.Contains(key))
+                    FetchAsync(key, false);
+            }
+
+            if (distance <= m_PrefetchBehind && p_Page - distance >= 0)
+            {
+                PageKey key = { m_Term, m_DocsPerPage, p_Page - distance };
+                if (!m_PageCache.Contains(key))
+                    FetchAsync(key, false);
+            }
         }
-        lxb_dom_collection_destroy(resultCounters, true);
+    }
 
-        lxb_dom_collection_t* divs = MakeCollection(&document->dom_document, lxb_dom_interface_element(document->body), "paragrafoBRS");
-            
-        std::unordered_map<std::u32string, std::vector<std::string>> lawsuits;
+    std::shared_future<PagePtr> Search::FetchAsync(const PageKey& p_Key, bool p_Urgent)
+    {
+        std::lock_guard<std::mutex> lock(m_InFlightMutex);
+
+        auto it = m_InFlight.find(p_Key);
+        if (it != m_InFlight.end())
+            return it->second.Future;
 
-        if (divs)
+        uint64_t generation = m_Generation.load();
+        std::shared_future<PagePtr> future = m_Executor->Submit([this, p_Key, generation]() -> PagePtr
         {
-            std::string currentType = "";
-            for (size_t i = 0; i < lxb_dom_collection_length(divs); i++) 
+            CancelFn isCancelled = [this, generation]() { return m_Generation.load() != generation; };
+
+            auto finish = [&](PagePtr p_Result)
             {
-                lxb_dom_element_t* div = lxb_dom_collection_element(divs, i);      
-                lxb_dom_node_t* child = lxb_dom_node_first_child(lxb_dom_interface_node(div));
-                
-                while (child != nullptr)
-                {
-                    if (child->type == LXB_DOM_NODE_TYPE_ELEMENT)
-                    {
-                        lxb_dom_element_t* element = lxb_dom_interface_element(child);
-                        
-                        std::string classAttr = GetElementAttribute(element, "class");
-                        std::string text = GetElementText(element);
-
-                        if (classAttr == "docTitulo")
-                        {
-                            currentType = text == "Relatora" ? "Relator" : Clean(text);
-                        }
-                        
-                        if (!currentType.empty() && classAttr == "docTexto")
-                        {
-                            lawsuits[Utf8ToU32(currentType)].push_back(Clean(text));
-                            currentType = "";
-                        }
-                    }
-                    
-                    child = lxb_dom_node_next(child);
-                }
+                std::lock_guard<std::mutex> lock(m_InFlightMutex);
+                auto entry = m_InFlight.find(p_Key);
+                if (entry != m_InFlight.end() && entry->second.Generation == generation)
+                    m_InFlight.erase(entry);
+                return p_Result;
+            };
+
+            if (isCancelled()) 
+                return finish(nullptr);
+
+            PagePtr page = m_PageCache.Get(p_Key);
+            try
+            {
+                if (!page)
+                    page = FetchPage(p_Key.Term, p_Key.DocsPerPage, p_Key.Page, isCancelled);
             }
-            
-            lxb_dom_collection_destroy(divs, true);
-        }
-        
-        lxb_html_document_destroy(document);
+            catch (...)
+            {
+                finish(nullptr);
+                throw;
+            }
+
+            if (page)
+                m_PageCache.Put(p_Key, page);
+
+            return finish(page);
+        }, p_Urgent).share();
+
+        m_InFlight[p_Key] = { generation, future };
+        return future;
+    }
+
+    std::shared_ptr<SearchPage> Search::FetchPage(const std::string& p_Term, int p_DocsPerPage, int p_Page, const CancelFn& p_IsCancelled, RetryBudget* p_Budget) const
+    {
+        auto schema = GetSchema();
 
-        m_Lawsuits.clear();
+        HtmlParser& parser = HtmlParser::GetThreadParser();
+        parser.SetSchema(schema);
+        std::string url = schema->FormatUrl(p_Term, p_DocsPerPage, p_Page);
+        if (!FetchHtml(url, parser, p_IsCancelled, p_Budget))
+            return nullptr;
 
-        size_t size = 0;
-        if (lawsuits.find(U"Processo") != lawsuits.end())
-            size = lawsuits[U"Processo"].size();
-        m_Lawsuits.reserve(size);
+        auto page = std::make_shared<SearchPage>();
+        page->Term = p_Term;
+        page->DocsPerPage = p_DocsPerPage;
+        page->Page = p_Page;
 
-        for (size_t i = 0; i < size; i++)
+        // a crawl dead letters it instead of counting an empty page, and a later retry must not get the same body back
+        if (!parser.End(*page))
         {
-            Lawsuit lawsuit;
-            lawsuit.Case            = lawsuits[U"Processo"][i];
-            lawsuit.Rapporteur      = lawsuits[U"Relator"][i];
-            lawsuit.JudgmentDate    = lawsuits[U"Data do Julgamento"][i];
-            lawsuit.Headnote        = lawsuits[U"Ementa"][i];
-            lawsuit.PubDate         = lawsuits[U"Data da Publicação/Fonte"][i];
-            lawsuit.Decision        = lawsuits[U"Acórdão"][i];
-
-            m_Lawsuits.push_back(lawsuit);
+            if (m_HttpCache)
+                m_HttpCache->Remove(url);
+            throw FetchError(FetchErrorKind::Parse, url, 0, std::format("Failed to parse page {} of {}", p_Page, p_Term));
         }
+
+        return page;
     }
 
-    void Search::FetchAndParseHtml(const std::string &p_Url)
+    void Search::Export(ExportFormat p_Format)
     {
-        std::string html = FetchHtml(p_Url);
-        ParseHtml(html);
+        std::string term = m_Term;
+        std::replace(term.begin(), term.end(), ' ', '-');
+
+        std::filesystem::path path = "Search-" + term + std::string(GetExtension(p_Format));
+
+        // the page keeps its records alive until the writer is done with them, the UI never waits on it
+        m_Export = m_Exporter->Submit([page = m_Page, term = m_Term, totalResults = m_TotalResults, p_Format, path]()
+        {
+            auto sink = CreateExportSink(p_Format, path);
+            if (!sink->Open(term, totalResults))
+                return;
+
+            if (page)
+            {
+                for (const auto& lawsuit : page->Lawsuits)
+                    sink->Write(lawsuit);
+            }
+            sink->Close();
+        });
     }
 
-    std::string Search::FetchHtml(const std::string& p_Url)
+    bool Search::FetchHtml(const std::string& p_Url, HtmlParser& p_Parser, const CancelFn& p_IsCancelled, RetryBudget* p_Budget) const
     {
-        cpr::Response r = cpr::Get(cpr::Url{p_Url},
-            cpr::Header{
-                {"User-Agent", "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36"},
-                {"Accept", "text/html,application/xhtml+xml,application/xml;q=0.9,image/webp,*/*;q=0.8"},
-                {"Accept-Language", "pt-BR,pt;q=0.9,en-US;q=0.8,en;q=0.7"},
-                {"Referer", "https://scon.stj.jus.br/"}
+        std::optional<CachedResponse> cached;
+        if (m_HttpCache)
+        {
+            cached = m_HttpCache->Load(p_Url);
+            if (cached && m_HttpCache->IsFresh(*cached))
+                return FeedCached(*cached, p_Parser);
+        }
+
+        cpr::Header header;
+        if (cached)
+            HttpCache::AddConditionalHeaders(*cached, header);
+
+        // returning false from the progress callback aborts the transfer
+        cpr::ProgressCallback progress([&p_IsCancelled](auto, auto, auto, auto, intptr_t) 
+        { 
+            return !(p_IsCancelled && p_IsCancelled()); 
         });
 
-        ASSERT(r.status_code == 200, std::format("Failed to access the site: {}", r.status_code));
+        // the body is parsed and cached as it downloads instead of being buffered into the response
+        std::unique_ptr<HttpCache::Writer> writer;
+        cpr::WriteCallback write([&](std::string_view p_Chunk, intptr_t)
+        {
+            p_Parser.Feed(p_Chunk);
+            if (writer)
+                writer->Append(p_Chunk);
 
-        if (m_SaveHtml)
+            return true;
+        });
+
+        if (p_Budget)
+            p_Budget->OnRequest();
+
+        for (uint32_t attempt = 0; ; attempt++)
         {
-            std::ofstream out("out.html", std::ios::out | std::ios::trunc);
-            out << r.text;
-            out.close();
-        }
+            if (!m_RateLimiter->Acquire(p_IsCancelled) || !m_Concurrency->Acquire(p_IsCancelled))
+                return false;
+            ConcurrencySlot slot(*m_Concurrency);
+
+            // a failed attempt may have fed an error page
+            p_Parser.Begin();
+            writer.reset(); // shares its temporary with the next one
+            if (m_HttpCache)
+                writer = m_HttpCache->BeginStore(p_Url);
+
+            auto start = std::chrono::steady_clock::now();
+            cpr::Response r = m_Sessions->Get(p_Url, header, progress, write, [&p_Parser](const cpr::Header& p_Header)
+            {
+                auto contentType = p_Header.find("Content-Type");
+                if (contentType != p_Header.end())
+                    p_Parser.SetContentType(contentType->second);
+            });
+            auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+            if (p_IsCancelled && p_IsCancelled())
+            {
+                slot.Release(RequestOutcome::Ignored, latency);
+                return false;
+            }
 
-        return r.text;
+            if (cached && r.status_code == 304)
+            {
+                slot.Release(RequestOutcome::Success, latency);
+                writer.reset();
+                m_HttpCache->Revalidate(p_Url, *cached, r.header);
+                return FeedCached(*cached, p_Parser);
+            }
+
+            if (!r.error && r.status_code == 200)
+            {
+                slot.Release(RequestOutcome::Success, latency);
+                if (writer)
+                    writer->Commit(r.status_code, r.header);
+
+                return true;
+            }
+
+            // only errors that may clear up mean the server is struggling, a 404 is just a 404
+            FetchError error = FetchError::FromResponse(p_Url, r);
+            slot.Release(error.IsRetryable() ? RequestOutcome::Overload : RequestOutcome::Success, latency);
+
+            if (!error.IsRetryable() || attempt + 1 >= m_RetryPolicy.MaxAttempts || (p_Budget && !p_Budget->TryConsume()))
+                throw error;
+
+            // a Retry-After of a day would park the worker for a day, the policy's ceiling still applies
+            std::chrono::milliseconds delay = error.GetRetryAfter().count() > 0 ? 
+                std::min<std::chrono::milliseconds>(error.GetRetryAfter(), m_RetryPolicy.MaxDelay) : m_RetryPolicy.GetDelay(attempt);
+            LOG("WARNING: {} (attempt {} of {}), retrying in {} ms", error.what(), attempt + 1, m_RetryPolicy.MaxAttempts, delay.count());
+
+            auto wakeUp = std::chrono::steady_clock::now() + delay;
+            while (std::chrono::steady_clock::now() < wakeUp)
+            {
+                if (p_IsCancelled && p_IsCancelled())
+                    return false;
+
+                std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(wakeUp - std::chrono::steady_clock::now(), std::chrono::milliseconds(50)));
+            }
+        }
     }
 }
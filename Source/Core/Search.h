@@ -2,25 +2,83 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string_view>
 
+#include "Arena.h"
+#include "PageCache.h"
+#include "Crawler.h"
+#include "Net/RetryPolicy.h"
 
 namespace SCPY
 {
-    struct Lawsuit
+    class ThreadPool;
+    class HtmlParser;
+    class HttpCache;
+    class SessionPool;
+    class RateLimiter;
+    class ConcurrencyLimiter;
+    class LawsuitSink;
+    struct ExtractionSchema;
+    enum class ExportFormat : uint8_t;
+
+    enum class LawsuitField : uint8_t
+    {
+        Case = 0, Rapporteur, JudgmentDate, PubDate, Headnote, Decision, Count
+    };
+
+    // Views into the Text arena of the page it came from, each one is NUL terminated
+    struct LawsuitView
+    {
+        std::string_view Case = "";
+        std::string_view Rapporteur = "";
+        std::string_view JudgmentDate = "";
+        std::string_view PubDate = "";
+        std::string_view Headnote = "";
+        std::string_view Decision = "";
+
+        std::string_view& operator[](LawsuitField p_Field);
+        const std::string_view& operator[](LawsuitField p_Field) const;
+    };
+
+    inline constexpr std::string_view LawsuitView::* s_LawsuitFields[] = {
+        &LawsuitView::Case, &LawsuitView::Rapporteur, &LawsuitView::JudgmentDate, &LawsuitView::PubDate, &LawsuitView::Headnote, &LawsuitView::Decision
+    };
+
+    // as they appear in exports and in the extraction schema
+    inline constexpr std::string_view s_LawsuitFieldNames[] = {
+        "Case", "Rapporteur", "JudgmentDate", "PubDate", "Headnote", "Decision"
+    };
+
+    inline std::string_view& LawsuitView::operator[](LawsuitField p_Field) { return this->*s_LawsuitFields[(size_t)p_Field]; }
+    inline const std::string_view& LawsuitView::operator[](LawsuitField p_Field) const { return this->*s_LawsuitFields[(size_t)p_Field]; }
+
+    struct SearchPage
     {
-        std::string Case;
-        std::string Rapporteur;
-        std::string JudgmentDate;
-        std::string PubDate;
-        std::string Headnote;
-        std::string Decision;
+        std::string Term;
+        int DocsPerPage = 0;
+        int Page = 0;
+        size_t TotalResults = 0;
+        std::vector<LawsuitView> Lawsuits;
+        Arena Text;
     };
 
+    using CancelFn = std::function<bool()>;
+    using PagePtr = std::shared_ptr<const SearchPage>;
+
     class Search
     {
         public:
-            Search() = default;
+            Search();
+            ~Search();
 
+            // Navigation only queues the request, the results show up on the next Update()
             void SearchTerm(const std::string& p_Term);
 
             void FirstPage();
@@ -29,38 +87,119 @@ namespace SCPY
             void LastPage();
 
             void Load();
-            void ExportYML();
+            // Writes the current page to Search-<term> on a background writer
+            void Export(ExportFormat p_Format);
+
+            // Harvests every result page of p_Term into p_Sink on a background thread.
+            // Uses the current page size, and the current result count when p_Term is the published search.
+            // Workers only caps the crawl, the shared ConcurrencyLimiter decides how many requests actually run.
+            std::shared_ptr<CrawlJob> Crawl(const std::string& p_Term, std::shared_ptr<LawsuitSink> p_Sink, CrawlOptions p_Options = {});
+
+            // Queues the dead letters of a finished crawl again. With a checkpoint this resumes the
+            // same crawl, so p_Sink must write to the same output; without one it gets only the retried pages.
+            std::shared_ptr<CrawlJob> Recrawl(CrawlJob& p_Failed, std::shared_ptr<LawsuitSink> p_Sink);
+
+            // Publishes the latest finished request and kicks off the prefetch around it,
+            // returns true when the results changed. Call it from the thread that reads the results (the UI thread).
+            bool Update();
+
+            // Blocking fetch and parse of a single page, safe to call from any thread.
+            // Returns nullptr when p_IsCancelled fires before the page is ready and throws FetchError
+            // once the retry policy (or p_Budget, when given) gives up.
+            std::shared_ptr<SearchPage> FetchPage(const std::string& p_Term, int p_DocsPerPage, int p_Page, 
+                const CancelFn& p_IsCancelled = nullptr, RetryBudget* p_Budget = nullptr) const;
 
             void SetDocsPerPage(int p_DocsPerPage) { m_DocsPerPage = p_DocsPerPage; }
-            void SetSaveHtml(bool p_SaveHtml) { m_SaveHtml = p_SaveHtml; }
+            // nullptr disables the disk cache, configure it before issuing requests
+            void SetHttpCache(std::shared_ptr<HttpCache> p_Cache) { m_HttpCache = std::move(p_Cache); }
+            // politeness towards SCON, shared by browsing, prefetch and crawls
+            void SetRateLimit(double p_RequestsPerSecond, double p_Burst);
+            void SetConcurrencyBounds(uint32_t p_Min, uint32_t p_Max);
+            void SetRetryPolicy(const RetryPolicy& p_Policy);
             void SetDeferredLoad(bool p_DeferredLoad) { m_DeferredLoad = p_DeferredLoad; }
+            void SetPrefetchWindow(int p_Ahead, int p_Behind) { m_PrefetchAhead = p_Ahead; m_PrefetchBehind = p_Behind; }
+            void SetPageCacheBudget(size_t p_Bytes) { m_PageCache.SetBudget(p_Bytes); }
+            // Fetches already running finish with the schema they started with, cached pages are dropped
+            void SetSchema(std::shared_ptr<const ExtractionSchema> p_Schema);
 
-            bool HasPrevPage() const { return m_HasPrevPage; }
-            bool HasNextPage() const { return m_HasNextPage; }
+            // The settings above plus the extraction schema, as YAML. Missing keys keep their current value.
+            bool LoadConfig(const std::filesystem::path& p_Path);
+            bool SaveConfig(const std::filesystem::path& p_Path);
+
+            bool HasPrevPage() const { return m_TargetPage > 0; }
+            bool HasNextPage() const { return size_t(m_TargetPage + 1) * size_t(m_DocsPerPage) < m_TotalResults; }
             bool IsHomePage() const { return m_CurrentPage == 0; }
+            bool IsLoading() const { return m_Pending.valid(); }
+            int GetLastPage() const { return m_TotalResults == 0 ? 0 : int((m_TotalResults - 1) / m_DocsPerPage); }
             size_t GetTotalResults() const { return m_TotalResults; }
             int GetCurrentPage() const { return m_CurrentPage; }
+            int GetTargetPage() const { return m_TargetPage; }
             int GetDocsPerPage() const { return m_DocsPerPage; }
             std::string GetTerm() const { return m_Term; }
-            const std::vector<Lawsuit>& GetLawsuits() const { return m_Lawsuits; }
+            const std::string& GetLastError() const { return m_LastError; }
+            const std::vector<LawsuitView>& GetLawsuits() const;
+            PageCache& GetPageCache() { return m_PageCache; }
+            const std::shared_ptr<HttpCache>& GetHttpCache() const { return m_HttpCache; }
+            const std::shared_ptr<RateLimiter>& GetRateLimiter() const { return m_RateLimiter; }
+            const std::shared_ptr<ConcurrencyLimiter>& GetConcurrencyLimiter() const { return m_Concurrency; }
+            std::shared_ptr<const ExtractionSchema> GetSchema() const;
 
         private:
-            std::string FetchHtml(const std::string& p_Url);
-            void ParseHtml(const std::string& p_Html);
-            void FetchAndParseHtml(const std::string& p_Url);
+            // Streams the body into p_Parser, false when cancelled
+            bool FetchHtml(const std::string& p_Url, HtmlParser& p_Parser, const CancelFn& p_IsCancelled, RetryBudget* p_Budget) const;
+
+            void RequestPage(int p_Page);
+            std::shared_ptr<CrawlJob> StartCrawl(const std::string& p_Term, std::shared_ptr<LawsuitSink> p_Sink, const CrawlOptions& p_Options);
+            void Publish(const PagePtr& p_Page);
+            void Prefetch(int p_Page);
+
+            // Shares one fetch between the page the user asked for and the prefetcher
+            std::shared_future<PagePtr> FetchAsync(const PageKey& p_Key, bool p_Urgent);
 
         private:
             std::string m_Term = "";
             int m_CurrentPage = 0;
+            int m_TargetPage = 0;
             int m_DocsPerPage = 10;
             size_t m_TotalResults = 0;
-            bool m_HasNextPage = true;
-            bool m_HasPrevPage = false;
             bool m_DeferredLoad = false;
-            bool m_SaveHtml = false;
 
-            std::string m_CurrentUrl = "";
+            int m_PrefetchAhead = 2;
+            int m_PrefetchBehind = 1;
+
+            PagePtr m_Page;
+            std::string m_LastError = "";
+            RetryPolicy m_RetryPolicy;
+
+            // A new term or page size bumps the generation, workers drop anything that is no longer current.
+            // Moving between pages of the same query only replaces m_Pending, the old fetch still lands in the cache.
+            std::atomic<uint64_t> m_Generation = 0;
+            PageKey m_Query;
+            std::shared_future<PagePtr> m_Pending;
+
+            struct InFlight
+            {
+                uint64_t Generation = 0;
+                std::shared_future<PagePtr> Future;
+            };
+            std::unordered_map<PageKey, InFlight, PageKeyHash> m_InFlight;
+            std::mutex m_InFlightMutex;
+
+            // crawls borrow FetchPage, they must be stopped before Search goes away
+            std::vector<std::weak_ptr<CrawlJob>> m_Crawls;
+
+            PageCache m_PageCache;
+            std::shared_ptr<HttpCache> m_HttpCache;
+            std::shared_ptr<SessionPool> m_Sessions;
+            std::shared_ptr<RateLimiter> m_RateLimiter;
+            std::shared_ptr<ConcurrencyLimiter> m_Concurrency;
+
+            std::shared_ptr<const ExtractionSchema> m_Schema;
+            mutable std::mutex m_SchemaMutex;
 
-            std::vector<Lawsuit> m_Lawsuits;
+            // one thread, so two exports of the same term never write the same file at once
+            std::unique_ptr<ThreadPool> m_Exporter;
+            std::future<void> m_Export;
+            std::unique_ptr<ThreadPool> m_Executor;
     };
-} // namespace SCPY
\ No newline at end of file
+} // namespace SCPY
@@ -0,0 +1,50 @@
+#include "Simd.h"
+
+#if defined(SCPY_X86) && defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+
+
+namespace SCPY
+{
+    bool HasSSSE3()
+    {
+    #if !defined(SCPY_X86)
+        return false;
+    #elif defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] & (1 << 9)) != 0;
+    #else
+        static const bool s_Supported = __builtin_cpu_supports("ssse3");
+        return s_Supported;
+    #endif
+    }
+
+    bool HasAVX2()
+    {
+    #if !defined(SCPY_X86)
+        return false;
+    #elif defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+
+        // the os has to save the ymm registers too
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+            return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    #else
+        static const bool s_Supported = __builtin_cpu_supports("avx2");
+        return s_Supported;
+    #endif
+    }
+
+} // namespace SCPY
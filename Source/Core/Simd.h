@@ -0,0 +1,23 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define SCPY_X86 1
+    #include <immintrin.h>
+
+    // lets a single function use instructions the rest of the build is not compiled for
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #define SCPY_TARGET(x)
+    #else
+        #define SCPY_TARGET(x) __attribute__((target(x)))
+    #endif
+#endif
+
+
+
+namespace SCPY
+{
+    // Runtime cpu checks for picking a kernel, both false off x86
+    bool HasSSSE3();
+    bool HasAVX2();
+
+} // namespace SCPY
@@ -0,0 +1,81 @@
+#include "ThreadPool.h"
+
+
+
+namespace SCPY
+{
+    ThreadPool::ThreadPool(uint32_t p_ThreadCount)
+    {
+        if (p_ThreadCount == 0)
+            p_ThreadCount = 1;
+
+        m_Threads.reserve(p_ThreadCount);
+        for (uint32_t i = 0; i < p_ThreadCount; i++)
+            m_Threads.emplace_back([this]() { WorkerLoop(); });
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stopping = true;
+            m_Tasks.clear();
+        }
+        m_Condition.notify_all();
+
+        for (auto& thread : m_Threads)
+        {
+            if (thread.joinable())
+                thread.join();
+        }
+    }
+
+    void ThreadPool::Clear()
+    {
+        std::deque<std::function<void()>> dropped;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            dropped.swap(m_Tasks);
+        }
+        // destroyed outside the lock, abandoning the packaged tasks
+    }
+
+    size_t ThreadPool::GetPendingCount()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Tasks.size();
+    }
+
+    void ThreadPool::Enqueue(std::function<void()> p_Task, bool p_Urgent)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (p_Urgent)
+                m_Tasks.push_front(std::move(p_Task));
+            else
+                m_Tasks.push_back(std::move(p_Task));
+        }
+        m_Condition.notify_one();
+    }
+
+    void ThreadPool::WorkerLoop()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_Condition.wait(lock, [this]() { return m_Stopping || !m_Tasks.empty(); });
+
+                if (m_Stopping)
+                    return;
+
+                task = std::move(m_Tasks.front());
+                m_Tasks.pop_front();
+            }
+
+            task();
+        }
+    }
+
+} // namespace SCPY
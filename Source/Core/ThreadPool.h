@@ -0,0 +1,61 @@
+#pragma once
+
+// std
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+
+namespace SCPY
+{
+    class ThreadPool
+    {
+        public:
+            explicit ThreadPool(uint32_t p_ThreadCount = 1);
+            ~ThreadPool();
+
+            ThreadPool(const ThreadPool&) = delete;
+            ThreadPool& operator=(const ThreadPool&) = delete;
+
+            // Urgent tasks jump ahead of everything already queued.
+            template<typename F>
+            auto Submit(F&& p_Task, bool p_Urgent = false) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+            {
+                using R = std::invoke_result_t<std::decay_t<F>>;
+
+                auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(p_Task));
+                std::future<R> future = task->get_future();
+
+                Enqueue([task]() { (*task)(); }, p_Urgent);
+
+                return future;
+            }
+
+            // Drops every task that has not started yet, their futures get a broken_promise.
+            void Clear();
+
+            uint32_t GetThreadCount() const { return (uint32_t)m_Threads.size(); }
+            size_t GetPendingCount();
+
+        private:
+            void Enqueue(std::function<void()> p_Task, bool p_Urgent);
+            void WorkerLoop();
+
+        private:
+            std::vector<std::thread> m_Threads;
+            std::deque<std::function<void()>> m_Tasks;
+
+            std::mutex m_Mutex;
+            std::condition_variable m_Condition;
+            bool m_Stopping = false;
+    };
+
+} // namespace SCPY
@@ -0,0 +1,122 @@
+#include "AsyncSink.h"
+
+// std
+#include <algorithm>
+
+
+
+namespace SCPY
+{
+    AsyncSink::AsyncSink(std::shared_ptr<LawsuitSink> p_Sink, size_t p_MaxPending)
+        : m_Sink(std::move(p_Sink)), m_MaxPending(std::max<size_t>(1, p_MaxPending))
+    {
+    }
+
+    AsyncSink::~AsyncSink()
+    {
+        Close();
+    }
+
+    bool AsyncSink::Open(const std::string& p_Term, size_t p_TotalResults)
+    {
+        if (!m_Sink->Open(p_Term, p_TotalResults))
+            return false;
+
+        Start();
+        return true;
+    }
+
+    bool AsyncSink::Resume(uint64_t p_Position)
+    {
+        if (!m_Sink->Resume(p_Position))
+            return false;
+
+        Start();
+        return true;
+    }
+
+    void AsyncSink::Write(const LawsuitView& p_Lawsuit)
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Condition.wait(lock, [this]() { return m_Pending.Records.size() < m_MaxPending; });
+
+        // the views point into a page that may be gone by the time the writer gets to them
+        LawsuitView& record = m_Pending.Records.emplace_back();
+        for (size_t i = 0; i < size_t(LawsuitField::Count); i++)
+            record[LawsuitField(i)] = m_Pending.Text.Store(p_Lawsuit[LawsuitField(i)]);
+
+        lock.unlock();
+        m_Condition.notify_all();
+    }
+
+    uint64_t AsyncSink::Flush()
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Condition.wait(lock, [this]() { return m_Pending.Records.empty() && !m_Busy; });
+
+        // the lock keeps the writer away from the sink meanwhile
+        return m_Sink->Flush();
+    }
+
+    void AsyncSink::Close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (m_Closing)
+                return;
+
+            m_Closing = true;
+        }
+        m_Condition.notify_all();
+
+        // never started, there is nothing to drain
+        if (!m_Thread.joinable())
+            m_Sink->Close();
+
+        Wait();
+    }
+
+    void AsyncSink::Wait()
+    {
+        if (m_Thread.joinable())
+            m_Thread.join();
+    }
+
+    void AsyncSink::Start()
+    {
+        if (m_Thread.joinable())
+            return;
+
+        m_Closing = false;
+        m_Thread = std::thread([this]() { WriterLoop(); });
+    }
+
+    void AsyncSink::WriterLoop()
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        while (true)
+        {
+            m_Condition.wait(lock, [this]() { return m_Closing || !m_Pending.Records.empty(); });
+            if (m_Pending.Records.empty())
+                break;
+
+            std::swap(m_Pending, m_Writing);
+            m_Busy = true;
+            lock.unlock();
+            m_Condition.notify_all();
+
+            for (const auto& record : m_Writing.Records)
+                m_Sink->Write(record);
+
+            m_Writing.Records.clear();
+            m_Writing.Text.Reset();
+
+            lock.lock();
+            m_Busy = false;
+            m_Condition.notify_all();
+        }
+
+        m_Sink->Close();
+    }
+
+} // namespace SCPY
@@ -0,0 +1,68 @@
+#pragma once
+#include "LawsuitSink.h"
+#include "Core/Arena.h"
+
+// std
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+namespace SCPY
+{
+    // Runs another sink on a writer thread. Write copies the record and returns,
+    // so formatting and disk I/O never hold up the crawl or the UI.
+    class AsyncSink : public LawsuitSink
+    {
+        public:
+            // Write blocks once p_MaxPending records are waiting, a slow disk cannot grow the queue forever
+            explicit AsyncSink(std::shared_ptr<LawsuitSink> p_Sink, size_t p_MaxPending = 4096);
+            ~AsyncSink() override;
+
+            AsyncSink(const AsyncSink&) = delete;
+            AsyncSink& operator=(const AsyncSink&) = delete;
+
+            bool Open(const std::string& p_Term, size_t p_TotalResults) override;
+            void Write(const LawsuitView& p_Lawsuit) override;
+
+            // Blocks until the writer has drained the queue and closed the sink, so whoever reopens
+            // the same file afterwards never races the old writer
+            void Close() override;
+
+            bool Resume(uint64_t p_Position) override;
+
+            // Waits for the queue to drain, a checkpoint must not count records that are not written yet
+            uint64_t Flush() override;
+
+            // Blocks until everything is written and the sink is closed
+            void Wait();
+
+        private:
+            void Start();
+            void WriterLoop();
+
+        private:
+            struct Batch
+            {
+                Arena Text;
+                std::vector<LawsuitView> Records;
+            };
+
+            std::shared_ptr<LawsuitSink> m_Sink;
+            size_t m_MaxPending;
+
+            // the writer swaps them, so the arena memory is reused page after page
+            Batch m_Pending;
+            Batch m_Writing;
+            bool m_Busy = false;
+            bool m_Closing = false;
+
+            std::mutex m_Mutex;
+            std::condition_variable m_Condition;
+            std::thread m_Thread;
+    };
+
+} // namespace SCPY
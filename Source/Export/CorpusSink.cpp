@@ -0,0 +1,265 @@
+#include "CorpusSink.h"
+#include "Core/Base.h"
+#include "Core/Corpus.h"
+
+// std
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+
+
+namespace SCPY
+{
+    namespace
+    {
+        constexpr size_t s_RowSize = size_t(LawsuitField::Count) * sizeof(uint64_t);
+
+        bool AppendFile(std::ofstream& p_Output, const std::filesystem::path& p_Path)
+        {
+            std::error_code error;
+            if (std::filesystem::file_size(p_Path, error) == 0 || error)
+                return !error;
+
+            std::ifstream input(p_Path, std::ios::in | std::ios::binary);
+            p_Output << input.rdbuf();
+            return bool(p_Output);
+        }
+
+    } // namespace
+
+    CorpusSink::CorpusSink(const std::filesystem::path& p_Path)
+        : m_Path(p_Path)
+    {
+        m_PartsDirectory = m_Path;
+        m_PartsDirectory += ".parts";
+    }
+
+    CorpusSink::~CorpusSink()
+    {
+        Close();
+    }
+
+    bool CorpusSink::Open(const std::string& p_Term, size_t p_TotalResults)
+    {
+        std::error_code error;
+        std::filesystem::remove_all(m_PartsDirectory, error);
+        std::filesystem::create_directories(m_PartsDirectory, error);
+        if (error)
+        {
+            LOG("ERROR: Failed to create {}: {}", m_PartsDirectory.string(), error.message());
+            return false;
+        }
+
+        m_Term = p_Term;
+        m_TotalResults = p_TotalResults;
+
+        std::ofstream meta(GetPartPath("Meta"), std::ios::out | std::ios::binary | std::ios::trunc);
+        meta.write((const char*)&m_TotalResults, sizeof(m_TotalResults));
+        meta.write(m_Term.data(), (std::streamsize)m_Term.size());
+        if (!meta)
+            return false;
+
+        m_Count = 0;
+        std::fill(std::begin(m_BlobSizes), std::end(m_BlobSizes), 0);
+        return OpenParts(std::ios::trunc);
+    }
+
+    void CorpusSink::Write(const LawsuitView& p_Lawsuit)
+    {
+        if (!m_Open) return;
+
+        m_Index.write((const char*)m_BlobSizes, sizeof(m_BlobSizes));
+        for (size_t i = 0; i < s_FieldCount; i++)
+        {
+            std::string_view text = p_Lawsuit[LawsuitField(i)];
+            m_Blobs[i].write(text.data(), (std::streamsize)text.size());
+            m_Blobs[i].put('\0');
+            m_BlobSizes[i] += text.size() + 1;
+        }
+
+        m_Count++;
+    }
+
+    uint64_t CorpusSink::Flush()
+    {
+        m_Index.flush();
+        for (auto& blob : m_Blobs)
+            blob.flush();
+
+        return m_Count;
+    }
+
+    bool CorpusSink::Resume(uint64_t p_Position)
+    {
+        if (std::filesystem::exists(m_PartsDirectory))
+            return ResumeParts(p_Position);
+
+        // a crawl that was cancelled was joined anyway, take it apart again
+        auto corpus = Corpus::Open(m_Path);
+        if (!corpus || corpus->GetCount() < p_Position)
+            return false;
+
+        if (!Open(std::string(corpus->GetTerm()), corpus->GetTotalResults()))
+            return false;
+
+        for (size_t i = 0; i < p_Position; i++)
+            Write(corpus->Get(i));
+        return true;
+    }
+
+    bool CorpusSink::ResumeParts(uint64_t p_Count)
+    {
+        std::error_code error;
+
+        std::ifstream meta(GetPartPath("Meta"), std::ios::in | std::ios::binary);
+        meta.read((char*)&m_TotalResults, sizeof(m_TotalResults));
+        if (!meta)
+            return false;
+        m_Term.assign(std::istreambuf_iterator<char>(meta), std::istreambuf_iterator<char>());
+
+        std::filesystem::path indexPath = GetPartPath("Index");
+        if (std::filesystem::file_size(indexPath, error) < p_Count * s_RowSize || error)
+            return false;
+
+        // the last kept row says where its strings start, each one runs up to its NUL
+        uint64_t starts[s_FieldCount] = {};
+        uint64_t ends[s_FieldCount] = {};
+        if (p_Count > 0)
+        {
+            std::ifstream index(indexPath, std::ios::in | std::ios::binary);
+            index.seekg(std::streamoff((p_Count - 1) * s_RowSize));
+            index.read((char*)starts, sizeof(starts));
+            if (!index)
+                return false;
+
+            for (size_t i = 0; i < s_FieldCount; i++)
+            {
+                std::ifstream blob(GetPartPath(s_LawsuitFieldNames[i].data()), std::ios::in | std::ios::binary);
+                blob.seekg(std::streamoff(starts[i]));
+
+                std::string text;
+                std::getline(blob, text, '\0');
+                if (!blob)
+                    return false;
+
+                ends[i] = starts[i] + text.size() + 1;
+            }
+        }
+
+        // drop whatever was written after the checkpoint, those pages are fetched again
+        std::filesystem::resize_file(indexPath, p_Count * s_RowSize, error);
+        for (size_t i = 0; i < s_FieldCount && !error; i++)
+            std::filesystem::resize_file(GetPartPath(s_LawsuitFieldNames[i].data()), ends[i], error);
+
+        if (error)
+        {
+            LOG("ERROR: Failed to truncate the parts of {}: {}", m_Path.string(), error.message());
+            return false;
+        }
+
+        m_Count = p_Count;
+        std::copy(std::begin(ends), std::end(ends), std::begin(m_BlobSizes));
+        return OpenParts(std::ios::app);
+    }
+
+    void CorpusSink::Close()
+    {
+        if (!m_Open) return;
+        m_Open = false;
+
+        m_Index.close();
+        for (auto& blob : m_Blobs)
+            blob.close();
+
+        if (Join())
+        {
+            std::error_code error;
+            std::filesystem::remove_all(m_PartsDirectory, error);
+        }
+    }
+
+    bool CorpusSink::OpenParts(std::ios::openmode p_Mode)
+    {
+        m_Index.open(GetPartPath("Index"), std::ios::out | std::ios::binary | p_Mode);
+        bool opened = m_Index.is_open();
+
+        for (size_t i = 0; i < s_FieldCount; i++)
+        {
+            m_Blobs[i].open(GetPartPath(s_LawsuitFieldNames[i].data()), std::ios::out | std::ios::binary | p_Mode);
+            opened = opened && m_Blobs[i].is_open();
+        }
+
+        if (!opened)
+        {
+            LOG("ERROR: Failed to open the parts of {}", m_Path.string());
+            return false;
+        }
+
+        m_Open = true;
+        return true;
+    }
+
+    bool CorpusSink::Join()
+    {
+        CorpusHeader header = {};
+        std::memcpy(header.Magic, s_CorpusMagic, sizeof(s_CorpusMagic));
+        header.Version = s_CorpusVersion;
+        header.FieldCount = (uint32_t)s_FieldCount;
+        header.RecordCount = m_Count;
+        header.TotalResults = m_TotalResults;
+        header.TermOffset = sizeof(CorpusHeader);
+        header.TermSize = m_Term.size();
+
+        // the index is read in place as uint64_t
+        uint64_t offset = (header.TermOffset + header.TermSize + 1 + 7) & ~uint64_t(7);
+        header.IndexOffset = offset;
+        offset += m_Count * s_RowSize;
+
+        for (size_t i = 0; i < s_FieldCount; i++)
+        {
+            header.BlobOffsets[i] = offset;
+            header.BlobSizes[i] = m_BlobSizes[i];
+            offset += m_BlobSizes[i];
+        }
+
+        std::filesystem::path temporary = m_Path;
+        temporary += ".tmp";
+
+        {
+            std::ofstream out(temporary, std::ios::out | std::ios::binary | std::ios::trunc);
+            out.write((const char*)&header, sizeof(header));
+            out.write(m_Term.c_str(), (std::streamsize)m_Term.size() + 1);
+
+            constexpr char padding[8] = {};
+            out.write(padding, std::streamsize(header.IndexOffset - (header.TermOffset + header.TermSize + 1)));
+
+            bool written = bool(out) && AppendFile(out, GetPartPath("Index"));
+            for (size_t i = 0; i < s_FieldCount && written; i++)
+                written = AppendFile(out, GetPartPath(s_LawsuitFieldNames[i].data()));
+
+            out.flush();
+            if (!written || !out)
+            {
+                LOG("ERROR: Failed to write {}", temporary.string());
+                return false;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporary, m_Path, error);
+        if (error)
+        {
+            LOG("ERROR: Failed to commit {}: {}", m_Path.string(), error.message());
+            return false;
+        }
+
+        return true;
+    }
+
+    std::filesystem::path CorpusSink::GetPartPath(const char* p_Name) const
+    {
+        return m_PartsDirectory / p_Name;
+    }
+
+} // namespace SCPY
@@ -0,0 +1,52 @@
+#pragma once
+#include "LawsuitSink.h"
+
+// std
+#include <filesystem>
+#include <fstream>
+
+
+
+namespace SCPY
+{
+    // Writes a Corpus. Each field streams into its own part file next to the output
+    // and Close joins them, so the blobs end up contiguous without holding the crawl in memory.
+    class CorpusSink : public LawsuitSink
+    {
+        public:
+            explicit CorpusSink(const std::filesystem::path& p_Path);
+            ~CorpusSink() override;
+
+            bool Open(const std::string& p_Term, size_t p_TotalResults) override;
+            void Write(const LawsuitView& p_Lawsuit) override;
+            void Close() override;
+
+            // Positions are record counts. The parts of an interrupted crawl are cut back to the checkpoint,
+            // a corpus that was already joined is split into parts again.
+            bool Resume(uint64_t p_Position) override;
+            uint64_t Flush() override;
+
+        private:
+            bool OpenParts(std::ios::openmode p_Mode);
+            bool ResumeParts(uint64_t p_Count);
+            bool Join();
+
+            std::filesystem::path GetPartPath(const char* p_Name) const;
+
+        private:
+            static constexpr size_t s_FieldCount = size_t(LawsuitField::Count);
+
+            std::filesystem::path m_Path;
+            std::filesystem::path m_PartsDirectory;
+
+            std::string m_Term;
+            uint64_t m_TotalResults = 0;
+
+            std::ofstream m_Index;
+            std::ofstream m_Blobs[s_FieldCount];
+            uint64_t m_BlobSizes[s_FieldCount] = {};
+            uint64_t m_Count = 0;
+            bool m_Open = false;
+    };
+
+} // namespace SCPY
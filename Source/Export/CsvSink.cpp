@@ -0,0 +1,51 @@
+#include "CsvSink.h"
+
+
+
+namespace SCPY
+{
+    namespace
+    {
+        void AppendCsvField(std::string_view p_Text, std::string& p_Output)
+        {
+            if (p_Text.find_first_of(",\"\r\n") == std::string_view::npos)
+            {
+                p_Output.append(p_Text);
+                return;
+            }
+
+            p_Output += '"';
+            for (char c : p_Text)
+            {
+                if (c == '"')
+                    p_Output += '"';
+                p_Output += c;
+            }
+            p_Output += '"';
+        }
+
+    } // namespace
+
+    void CsvSink::FormatHeader(const std::string&, size_t, std::string& p_Output)
+    {
+        for (size_t i = 0; i < size_t(LawsuitField::Count); i++)
+        {
+            if (i > 0)
+                p_Output += ',';
+            p_Output += s_LawsuitFieldNames[i];
+        }
+        p_Output += "\r\n";
+    }
+
+    void CsvSink::FormatRecord(const LawsuitView& p_Lawsuit, std::string& p_Output)
+    {
+        for (size_t i = 0; i < size_t(LawsuitField::Count); i++)
+        {
+            if (i > 0)
+                p_Output += ',';
+            AppendCsvField(p_Lawsuit[LawsuitField(i)], p_Output);
+        }
+        p_Output += "\r\n";
+    }
+
+} // namespace SCPY
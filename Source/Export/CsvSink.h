@@ -0,0 +1,19 @@
+#pragma once
+#include "FileSink.h"
+
+
+
+namespace SCPY
+{
+    // RFC 4180: a header row with the field names, then one row per record
+    class CsvSink : public FileSink
+    {
+        public:
+            using FileSink::FileSink;
+
+        protected:
+            void FormatHeader(const std::string& p_Term, size_t p_TotalResults, std::string& p_Output) override;
+            void FormatRecord(const LawsuitView& p_Lawsuit, std::string& p_Output) override;
+    };
+
+} // namespace SCPY
@@ -0,0 +1,50 @@
+#include "ExportFormat.h"
+#include "YamlSink.h"
+#include "JsonLinesSink.h"
+#include "CsvSink.h"
+#include "CorpusSink.h"
+
+
+
+namespace SCPY
+{
+    std::string_view GetExtension(ExportFormat p_Format)
+    {
+        switch (p_Format)
+        {
+            case ExportFormat::JsonLines:   return ".jsonl";
+            case ExportFormat::Csv:         return ".csv";
+            case ExportFormat::Corpus:      return ".scpc";
+            default:                        return ".yml";
+        }
+    }
+
+    std::optional<ExportFormat> FindExportFormat(std::string_view p_Name)
+    {
+        if (!p_Name.empty() && p_Name.front() == '.')
+            p_Name.remove_prefix(1);
+
+        if (p_Name == "yml" || p_Name == "yaml")
+            return ExportFormat::Yaml;
+        if (p_Name == "jsonl" || p_Name == "json")
+            return ExportFormat::JsonLines;
+        if (p_Name == "csv")
+            return ExportFormat::Csv;
+        if (p_Name == "scpc" || p_Name == "corpus")
+            return ExportFormat::Corpus;
+
+        return std::nullopt;
+    }
+
+    std::shared_ptr<LawsuitSink> CreateExportSink(ExportFormat p_Format, const std::filesystem::path& p_Path)
+    {
+        switch (p_Format)
+        {
+            case ExportFormat::JsonLines:   return std::make_shared<JsonLinesSink>(p_Path);
+            case ExportFormat::Csv:         return std::make_shared<CsvSink>(p_Path);
+            case ExportFormat::Corpus:      return std::make_shared<CorpusSink>(p_Path);
+            default:                        return std::make_shared<YamlSink>(p_Path);
+        }
+    }
+
+} // namespace SCPY
@@ -0,0 +1,30 @@
+#pragma once
+#include "LawsuitSink.h"
+
+// std
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+
+
+namespace SCPY
+{
+    enum class ExportFormat : uint8_t
+    {
+        Yaml = 0, JsonLines, Csv, Corpus, Count
+    };
+
+    inline constexpr const char* s_ExportFormatNames[] = { "YAML", "JSON Lines", "CSV", "Corpus" };
+
+    // with the dot (ex: ".jsonl")
+    std::string_view GetExtension(ExportFormat p_Format);
+
+    // From an extension or a short name (ex: "csv", ".yml", "jsonl", "scpc")
+    std::optional<ExportFormat> FindExportFormat(std::string_view p_Name);
+
+    std::shared_ptr<LawsuitSink> CreateExportSink(ExportFormat p_Format, const std::filesystem::path& p_Path);
+
+} // namespace SCPY
@@ -0,0 +1,87 @@
+#include "FileSink.h"
+#include "Core/Base.h"
+
+
+
+namespace SCPY
+{
+    FileSink::FileSink(const std::filesystem::path& p_Path)
+        : m_Path(p_Path)
+    {
+    }
+
+    FileSink::~FileSink()
+    {
+        // too late for the virtual formatters, but the buffer is plain bytes by now
+        Close();
+    }
+
+    bool FileSink::Open(const std::string& p_Term, size_t p_TotalResults)
+    {
+        m_File.open(m_Path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!m_File)
+        {
+            LOG("ERROR: Failed to open {}", m_Path.string());
+            return false;
+        }
+
+        m_Buffer.clear();
+        m_Buffer.reserve(s_BufferSize);
+        FormatHeader(p_Term, p_TotalResults, m_Buffer);
+        return true;
+    }
+
+    void FileSink::Write(const LawsuitView& p_Lawsuit)
+    {
+        FormatRecord(p_Lawsuit, m_Buffer);
+        if (m_Buffer.size() >= s_BufferSize)
+            WriteBuffer();
+    }
+
+    bool FileSink::Resume(uint64_t p_Position)
+    {
+        std::error_code error;
+        if (!std::filesystem::exists(m_Path, error) || std::filesystem::file_size(m_Path, error) < p_Position)
+            return false;
+
+        // drop whatever was written after the checkpoint, those pages are fetched again
+        std::filesystem::resize_file(m_Path, p_Position, error);
+        if (error)
+        {
+            LOG("ERROR: Failed to truncate {}: {}", m_Path.string(), error.message());
+            return false;
+        }
+
+        m_Buffer.clear();
+        m_Buffer.reserve(s_BufferSize);
+        m_File.open(m_Path, std::ios::out | std::ios::binary | std::ios::app);
+        m_File.seekp(0, std::ios::end);
+        return m_File.is_open();
+    }
+
+    uint64_t FileSink::Flush()
+    {
+        WriteBuffer();
+        m_File.flush();
+        return (uint64_t)m_File.tellp();
+    }
+
+    void FileSink::Close()
+    {
+        if (!m_File.is_open())
+            return;
+
+        WriteBuffer();
+        m_File.close();
+    }
+
+    void FileSink::WriteBuffer()
+    {
+        if (m_Buffer.empty() || !m_File.is_open())
+            return;
+
+        m_File.write(m_Buffer.data(), (std::streamsize)m_Buffer.size());
+        m_Buffer.clear();
+    }
+
+} // namespace SCPY
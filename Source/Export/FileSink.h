@@ -0,0 +1,46 @@
+#pragma once
+#include "LawsuitSink.h"
+
+// std
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+
+
+namespace SCPY
+{
+    // Base of the file exporters: records are formatted into a memory buffer
+    // and reach the file in large writes, one page of records rarely takes more than one.
+    class FileSink : public LawsuitSink
+    {
+        public:
+            explicit FileSink(const std::filesystem::path& p_Path);
+            ~FileSink() override;
+
+            bool Open(const std::string& p_Term, size_t p_TotalResults) override;
+            void Write(const LawsuitView& p_Lawsuit) override;
+            void Close() override;
+
+            bool Resume(uint64_t p_Position) override;
+            uint64_t Flush() override;
+
+            const std::filesystem::path& GetPath() const { return m_Path; }
+
+        protected:
+            // Appends to p_Output, the header is skipped when a resumed file already has it
+            virtual void FormatHeader(const std::string& p_Term, size_t p_TotalResults, std::string& p_Output) = 0;
+            virtual void FormatRecord(const LawsuitView& p_Lawsuit, std::string& p_Output) = 0;
+
+        private:
+            void WriteBuffer();
+
+        private:
+            static constexpr size_t s_BufferSize = 256 * 1024;
+
+            std::filesystem::path m_Path;
+            std::ofstream m_File;
+            std::string m_Buffer;
+    };
+
+} // namespace SCPY
@@ -0,0 +1,61 @@
+#include "JsonLinesSink.h"
+
+
+
+namespace SCPY
+{
+    namespace
+    {
+        // the text is UTF-8 already, only quotes, backslashes and controls need escaping
+        void AppendJsonString(std::string_view p_Text, std::string& p_Output)
+        {
+            constexpr char hex[] = "0123456789abcdef";
+
+            p_Output += '"';
+            size_t start = 0;
+            for (size_t i = 0; i < p_Text.size(); i++)
+            {
+                unsigned char c = (unsigned char)p_Text[i];
+                if (c >= 0x20 && c != '"' && c != '\\')
+                    continue;
+
+                p_Output.append(p_Text, start, i - start);
+                start = i + 1;
+
+                switch (c)
+                {
+                    case '"':   p_Output += "\\\""; break;
+                    case '\\':  p_Output += "\\\\"; break;
+                    case '\n':  p_Output += "\\n"; break;
+                    case '\r':  p_Output += "\\r"; break;
+                    case '\t':  p_Output += "\\t"; break;
+                    default:
+                        p_Output += "\\u00";
+                        p_Output += hex[c >> 4];
+                        p_Output += hex[c & 15];
+                        break;
+                }
+            }
+            p_Output.append(p_Text, start);
+            p_Output += '"';
+        }
+
+    } // namespace
+
+    void JsonLinesSink::FormatRecord(const LawsuitView& p_Lawsuit, std::string& p_Output)
+    {
+        p_Output += '{';
+        for (size_t i = 0; i < size_t(LawsuitField::Count); i++)
+        {
+            if (i > 0)
+                p_Output += ',';
+
+            p_Output += '"';
+            p_Output += s_LawsuitFieldNames[i];
+            p_Output += "\":";
+            AppendJsonString(p_Lawsuit[LawsuitField(i)], p_Output);
+        }
+        p_Output += "}\n";
+    }
+
+} // namespace SCPY
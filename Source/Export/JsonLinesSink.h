@@ -0,0 +1,19 @@
+#pragma once
+#include "FileSink.h"
+
+
+
+namespace SCPY
+{
+    // One JSON object per line and per record, the term and result count are left to the file name
+    class JsonLinesSink : public FileSink
+    {
+        public:
+            using FileSink::FileSink;
+
+        protected:
+            void FormatHeader(const std::string&, size_t, std::string&) override {}
+            void FormatRecord(const LawsuitView& p_Lawsuit, std::string& p_Output) override;
+    };
+
+} // namespace SCPY
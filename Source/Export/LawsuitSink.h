@@ -0,0 +1,30 @@
+#pragma once
+#include "Core/Search.h"
+
+// std
+#include <cstdint>
+#include <string>
+
+
+
+namespace SCPY
+{
+    // Receives records one at a time, in page order, while a crawl is running
+    class LawsuitSink
+    {
+        public:
+            virtual ~LawsuitSink() = default;
+
+            virtual bool Open(const std::string& p_Term, size_t p_TotalResults) = 0;
+            virtual void Write(const LawsuitView& p_Lawsuit) = 0;
+            virtual void Close() = 0;
+
+            // Reopens an existing output cut back to the given position, for crawls resumed from a checkpoint.
+            // Sinks that cannot append return false and the crawl starts over.
+            virtual bool Resume(uint64_t) { return false; }
+
+            // Pushes buffered records out and returns the position Resume takes back, bytes of output for the text sinks
+            virtual uint64_t Flush() { return 0; }
+    };
+
+} // namespace SCPY
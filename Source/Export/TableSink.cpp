@@ -0,0 +1,24 @@
+#include "TableSink.h"
+
+
+
+namespace SCPY
+{
+    TableSink::TableSink(LawsuitTable& p_Table)
+        : m_Table(p_Table)
+    {
+    }
+
+    bool TableSink::Open(const std::string&, size_t p_TotalResults)
+    {
+        m_Table.Clear();
+        m_Table.Reserve(p_TotalResults);
+        return true;
+    }
+
+    void TableSink::Write(const LawsuitView& p_Lawsuit)
+    {
+        m_Table.Append(p_Lawsuit);
+    }
+
+} // namespace SCPY
@@ -0,0 +1,23 @@
+#pragma once
+#include "LawsuitSink.h"
+#include "Core/LawsuitTable.h"
+
+
+
+namespace SCPY
+{
+    // Collects a crawl in memory as a columnar table
+    class TableSink : public LawsuitSink
+    {
+        public:
+            explicit TableSink(LawsuitTable& p_Table);
+
+            bool Open(const std::string& p_Term, size_t p_TotalResults) override;
+            void Write(const LawsuitView& p_Lawsuit) override;
+            void Close() override {}
+
+        private:
+            LawsuitTable& m_Table;
+    };
+
+} // namespace SCPY
@@ -0,0 +1,35 @@
+#include "YamlSink.h"
+
+// lib
+#include <yaml-cpp/yaml.h>
+
+
+
+namespace SCPY
+{
+    void YamlSink::FormatHeader(const std::string& p_Term, size_t p_TotalResults, std::string& p_Output)
+    {
+        YAML::Emitter out;
+        out << YAML::BeginMap;
+        out << YAML::Key << "Term" << YAML::Value << p_Term;
+        out << YAML::Key << "TotalResults" << YAML::Value << p_TotalResults;
+        out << YAML::EndMap;
+
+        // the records follow as a block sequence, one emitter per record
+        p_Output.append(out.c_str(), out.size());
+        p_Output += "\nLawsuits:\n";
+    }
+
+    void YamlSink::FormatRecord(const LawsuitView& p_Lawsuit, std::string& p_Output)
+    {
+        YAML::Emitter out;
+        out << YAML::BeginSeq << YAML::BeginMap;
+        for (size_t i = 0; i < size_t(LawsuitField::Count); i++)
+            out << YAML::Key << std::string(s_LawsuitFieldNames[i]) << YAML::Value << p_Lawsuit[LawsuitField(i)].data();
+        out << YAML::EndMap << YAML::EndSeq;
+
+        p_Output.append(out.c_str(), out.size());
+        p_Output += '\n';
+    }
+
+} // namespace SCPY
@@ -0,0 +1,19 @@
+#pragma once
+#include "FileSink.h"
+
+
+
+namespace SCPY
+{
+    // Same layout as the YAML export of a page, but each record is appended as soon as it arrives
+    class YamlSink : public FileSink
+    {
+        public:
+            using FileSink::FileSink;
+
+        protected:
+            void FormatHeader(const std::string& p_Term, size_t p_TotalResults, std::string& p_Output) override;
+            void FormatRecord(const LawsuitView& p_Lawsuit, std::string& p_Output) override;
+    };
+
+} // namespace SCPY
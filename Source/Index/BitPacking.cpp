@@ -0,0 +1,208 @@
+#include "BitPacking.h"
+#include "Core/Simd.h"
+
+// std
+#include <cstring>
+
+
+
+namespace SCPY
+{
+    namespace
+    {
+        constexpr size_t s_Lanes = 4;
+        constexpr size_t s_LaneValues = s_PackedBlockSize / s_Lanes;
+
+        inline uint32_t GetMask(uint8_t p_Bits)
+        {
+            return p_Bits >= 32 ? 0xFFFFFFFFu : (1u << p_Bits) - 1;
+        }
+
+        inline uint32_t LoadWord(const uint8_t* p_Input, size_t p_Word)
+        {
+            uint32_t word;
+            std::memcpy(&word, p_Input + p_Word * sizeof(uint32_t), sizeof(uint32_t));
+            return word;
+        }
+
+    #ifdef SCPY_X86
+        // Same walk as the scalar unpack, the four lanes at once
+        SCPY_TARGET("sse2")
+        void UnpackSSE2(const uint8_t* p_Input, uint8_t p_Bits, uint32_t* p_Values)
+        {
+            const __m128i* input = (const __m128i*)p_Input;
+            __m128i* output = (__m128i*)p_Values;
+            const __m128i mask = _mm_set1_epi32((int)GetMask(p_Bits));
+
+            __m128i word = _mm_loadu_si128(input++);
+            uint32_t shift = 0;
+            for (size_t i = 0; i < s_LaneValues; i++)
+            {
+                __m128i value = _mm_srl_epi32(word, _mm_cvtsi32_si128((int)shift));
+                shift += p_Bits;
+
+                if (shift >= 32)
+                {
+                    shift -= 32;
+                    if (i + 1 < s_LaneValues || shift > 0)
+                        word = _mm_loadu_si128(input++);
+
+                    // the value runs on into the next word
+                    if (shift > 0)
+                        value = _mm_or_si128(value, _mm_sll_epi32(word, _mm_cvtsi32_si128(int(p_Bits - shift))));
+                }
+
+                _mm_storeu_si128(output++, _mm_and_si128(value, mask));
+            }
+        }
+
+        SCPY_TARGET("sse2")
+        void DecodeGapsSSE2(uint32_t* p_Values, size_t p_Count, uint32_t p_Previous)
+        {
+            const __m128i one = _mm_set1_epi32(1);
+            __m128i carry = _mm_set1_epi32((int)p_Previous);
+
+            size_t i = 0;
+            for (; i + 4 <= p_Count; i += 4)
+            {
+                // prefix sum in two shifted adds, then everything before this register on top
+                __m128i gaps = _mm_add_epi32(_mm_loadu_si128((const __m128i*)(p_Values + i)), one);
+                gaps = _mm_add_epi32(gaps, _mm_slli_si128(gaps, 4));
+                gaps = _mm_add_epi32(gaps, _mm_slli_si128(gaps, 8));
+                gaps = _mm_add_epi32(gaps, carry);
+
+                _mm_storeu_si128((__m128i*)(p_Values + i), gaps);
+                carry = _mm_shuffle_epi32(gaps, _MM_SHUFFLE(3, 3, 3, 3));
+            }
+
+            DecodeGapsScalar(p_Values + i, p_Count - i, (uint32_t)_mm_cvtsi128_si32(carry));
+        }
+    #endif
+
+        struct Kernel
+        {
+            void (*Unpack)(const uint8_t*, uint8_t, uint32_t*);
+            void (*DecodeGaps)(uint32_t*, size_t, uint32_t);
+            const char* Name;
+        };
+
+        Kernel SelectKernel()
+        {
+        #ifdef SCPY_X86
+            return { UnpackSSE2, DecodeGapsSSE2, "SSE2" };
+        #else
+            return { UnpackBlockScalar, DecodeGapsScalar, "Scalar" };
+        #endif
+        }
+
+        const Kernel& GetKernel()
+        {
+            static const Kernel s_Kernel = SelectKernel();
+            return s_Kernel;
+        }
+
+    } // namespace
+
+    uint8_t GetBitWidth(const uint32_t* p_Values, size_t p_Count)
+    {
+        uint32_t all = 0;
+        for (size_t i = 0; i < p_Count; i++)
+            all |= p_Values[i];
+
+        uint8_t bits = 0;
+        while (all != 0)
+        {
+            bits++;
+            all >>= 1;
+        }
+        return bits;
+    }
+
+    void PackBlock(const uint32_t* p_Values, uint8_t p_Bits, uint8_t* p_Output)
+    {
+        if (p_Bits == 0)
+            return;
+        std::memset(p_Output, 0, GetPackedByteSize(p_Bits));
+
+        for (size_t lane = 0; lane < s_Lanes; lane++)
+        {
+            size_t word = 0;
+            uint32_t shift = 0;
+            uint32_t current = 0;
+            for (size_t i = 0; i < s_LaneValues; i++)
+            {
+                uint32_t value = p_Values[i * s_Lanes + lane];
+                current |= value << shift;
+                shift += p_Bits;
+
+                if (shift >= 32)
+                {
+                    std::memcpy(p_Output + (word * s_Lanes + lane) * sizeof(uint32_t), &current, sizeof(uint32_t));
+                    word++;
+                    shift -= 32;
+                    current = shift > 0 ? value >> (p_Bits - shift) : 0;
+                }
+            }
+        }
+    }
+
+    void UnpackBlockScalar(const uint8_t* p_Input, uint8_t p_Bits, uint32_t* p_Values)
+    {
+        if (p_Bits == 0)
+        {
+            std::memset(p_Values, 0, s_PackedBlockSize * sizeof(uint32_t));
+            return;
+        }
+
+        uint32_t mask = GetMask(p_Bits);
+        for (size_t lane = 0; lane < s_Lanes; lane++)
+        {
+            size_t word = 0;
+            uint32_t shift = 0;
+            for (size_t i = 0; i < s_LaneValues; i++)
+            {
+                uint64_t bits = LoadWord(p_Input, word * s_Lanes + lane);
+                if (shift + p_Bits > 32)
+                    bits |= uint64_t(LoadWord(p_Input, (word + 1) * s_Lanes + lane)) << 32;
+
+                p_Values[i * s_Lanes + lane] = uint32_t(bits >> shift) & mask;
+                shift += p_Bits;
+                if (shift >= 32)
+                {
+                    word++;
+                    shift -= 32;
+                }
+            }
+        }
+    }
+
+    void DecodeGapsScalar(uint32_t* p_Values, size_t p_Count, uint32_t p_Previous)
+    {
+        for (size_t i = 0; i < p_Count; i++)
+        {
+            p_Previous += p_Values[i] + 1;
+            p_Values[i] = p_Previous;
+        }
+    }
+
+    void UnpackBlock(const uint8_t* p_Input, uint8_t p_Bits, uint32_t* p_Values)
+    {
+        if (p_Bits == 0)
+        {
+            std::memset(p_Values, 0, s_PackedBlockSize * sizeof(uint32_t));
+            return;
+        }
+        GetKernel().Unpack(p_Input, p_Bits, p_Values);
+    }
+
+    void DecodeGaps(uint32_t* p_Values, size_t p_Count, uint32_t p_Previous)
+    {
+        GetKernel().DecodeGaps(p_Values, p_Count, p_Previous);
+    }
+
+    const char* GetPackingKernelName()
+    {
+        return GetKernel().Name;
+    }
+
+} // namespace SCPY
@@ -0,0 +1,38 @@
+#pragma once
+
+// std
+#include <cstddef>
+#include <cstdint>
+
+
+
+namespace SCPY
+{
+    // Blocks of 128 integers packed with a common bit width, four values side by side (value i sits
+    // in lane i % 4 of 32 bit words) so a 128 bit register unpacks four of them per shift and mask.
+    // A block takes p_Bits * 16 bytes, 0 bits when every value is 0.
+    inline constexpr size_t s_PackedBlockSize = 128;
+
+    inline constexpr size_t GetPackedByteSize(uint8_t p_Bits) { return size_t(p_Bits) * 16; }
+
+    // Bits needed by the largest of p_Values
+    uint8_t GetBitWidth(const uint32_t* p_Values, size_t p_Count);
+
+    // Packs s_PackedBlockSize values, each has to fit in p_Bits
+    void PackBlock(const uint32_t* p_Values, uint8_t p_Bits, uint8_t* p_Output);
+
+    // Reads GetPackedByteSize(p_Bits) bytes from p_Input into s_PackedBlockSize values
+    void UnpackBlock(const uint8_t* p_Input, uint8_t p_Bits, uint32_t* p_Values);
+
+    // Turns gaps into the values they lead to, in place: value i becomes p_Previous + 1 + the sum of gaps 0 to i.
+    // Strictly ascending documents store one less than their distance, so a dense run packs to 0 bits.
+    void DecodeGaps(uint32_t* p_Values, size_t p_Count, uint32_t p_Previous);
+
+    // Portable references, also what the other kernels are checked against
+    void UnpackBlockScalar(const uint8_t* p_Input, uint8_t p_Bits, uint32_t* p_Values);
+    void DecodeGapsScalar(uint32_t* p_Values, size_t p_Count, uint32_t p_Previous);
+
+    // "SSE2" or "Scalar", whichever the dispatcher picked for this cpu
+    const char* GetPackingKernelName();
+
+} // namespace SCPY
@@ -0,0 +1,398 @@
+#include "InvertedIndex.h"
+#include "Query.h"
+#include "Core/Corpus.h"
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <optional>
+
+
+
+namespace SCPY
+{
+    namespace
+    {
+        // keeps phrases from running from one field into the next
+        constexpr uint32_t s_FieldGap = 16;
+
+        constexpr float s_K1 = 1.2f;
+        constexpr float s_B = 0.75f;
+
+        using DocSet = std::vector<uint32_t>;
+
+        // gallops through the longer set for each document of the shorter one
+        DocSet Intersect(const DocSet& p_Left, const DocSet& p_Right)
+        {
+            const DocSet& shorter = p_Left.size() <= p_Right.size() ? p_Left : p_Right;
+            const DocSet& longer = p_Left.size() <= p_Right.size() ? p_Right : p_Left;
+
+            DocSet result;
+            const uint32_t* at = longer.data();
+            const uint32_t* end = longer.data() + longer.size();
+            for (uint32_t doc : shorter)
+            {
+                at = Gallop(at, end, doc);
+                if (at == end)
+                    break;
+                if (*at == doc)
+                    result.push_back(doc);
+            }
+            return result;
+        }
+
+        DocSet Unite(const DocSet& p_Left, const DocSet& p_Right)
+        {
+            DocSet result;
+            std::set_union(p_Left.begin(), p_Left.end(), p_Right.begin(), p_Right.end(), std::back_inserter(result));
+            return result;
+        }
+
+        DocSet Subtract(const DocSet& p_Left, const DocSet& p_Right)
+        {
+            DocSet result;
+            std::set_difference(p_Left.begin(), p_Left.end(), p_Right.begin(), p_Right.end(), std::back_inserter(result));
+            return result;
+        }
+
+    } // namespace
+
+    // Turns a query tree into the matching documents, remembering the
+    // documents and frequencies of every term or phrase that counts towards the score
+    class QueryEvaluator
+    {
+        public:
+            struct Leaf
+            {
+                DocSet Docs;
+                std::vector<uint32_t> Frequencies;
+                uint32_t DocCount = 0; // across the index, Docs may only hold the ones an AND asked about
+            };
+
+            explicit QueryEvaluator(const InvertedIndex& p_Index)
+                : m_Index(p_Index)
+            {
+            }
+
+            DocSet Evaluate(const QueryNode& p_Node, bool p_Scored)
+            {
+                switch (p_Node.Op)
+                {
+                    case QueryOp::Term:     return Keep(MatchTerm(p_Node.Terms.front()), p_Scored);
+                    case QueryOp::Phrase:   return Keep(MatchPhrase(p_Node), p_Scored);
+                    case QueryOp::Or:       return EvaluateOr(p_Node, p_Scored);
+                    case QueryOp::And:      return EvaluateAnd(p_Node, p_Scored);
+                    case QueryOp::Not:      return Subtract(GetAllDocs(), Evaluate(p_Node.Children.front(), false));
+                }
+                return {};
+            }
+
+            const std::vector<Leaf>& GetLeaves() const { return m_Leaves; }
+
+        private:
+            DocSet Keep(Leaf p_Leaf, bool p_Scored)
+            {
+                if (!p_Scored)
+                    return std::move(p_Leaf.Docs);
+
+                m_Leaves.push_back(std::move(p_Leaf));
+                return m_Leaves.back().Docs;
+            }
+
+            DocSet EvaluateOr(const QueryNode& p_Node, bool p_Scored)
+            {
+                DocSet result;
+                for (const auto& child : p_Node.Children)
+                    result = Unite(result, Evaluate(child, p_Scored));
+                return result;
+            }
+
+            // "a e não b" is a difference, the complement of b is never built.
+            // Plain terms are intersected rarest first with their cursors, which skip every block
+            // that holds no candidate, so a common term next to a rare one is barely decoded.
+            DocSet EvaluateAnd(const QueryNode& p_Node, bool p_Scored)
+            {
+                std::optional<DocSet> result;
+                std::vector<const PostingList*> terms;
+                for (const auto& child : p_Node.Children)
+                {
+                    if (child.Op == QueryOp::Not) continue;
+
+                    if (child.Op == QueryOp::Term)
+                    {
+                        const PostingList* postings = m_Index.FindPostings(child.Terms.front());
+                        if (!postings)
+                            return {};
+                        terms.push_back(postings);
+                        continue;
+                    }
+
+                    DocSet docs = Evaluate(child, p_Scored);
+                    result = result ? Intersect(*result, docs) : std::move(docs);
+                }
+
+                std::sort(terms.begin(), terms.end(), [](const PostingList* p_Left, const PostingList* p_Right)
+                {
+                    return p_Left->GetDocCount() < p_Right->GetDocCount();
+                });
+
+                for (const PostingList* postings : terms)
+                {
+                    Leaf leaf = result ? MatchTerm(*postings, *result) : MatchTerm(*postings);
+                    result = leaf.Docs;
+                    Keep(std::move(leaf), p_Scored);
+                }
+
+                if (!result)
+                    result = GetAllDocs();
+
+                for (const auto& child : p_Node.Children)
+                {
+                    if (child.Op == QueryOp::Not && !result->empty())
+                        result = Subtract(*result, Evaluate(child.Children.front(), false));
+                }
+
+                return std::move(*result);
+            }
+
+            Leaf MatchTerm(const std::string& p_Term)
+            {
+                const PostingList* postings = m_Index.FindPostings(p_Term);
+                return postings ? MatchTerm(*postings) : Leaf();
+            }
+
+            Leaf MatchTerm(const PostingList& p_Postings)
+            {
+                Leaf leaf;
+                leaf.DocCount = p_Postings.GetDocCount();
+                leaf.Docs.reserve(p_Postings.GetDocCount());
+                leaf.Frequencies.reserve(p_Postings.GetDocCount());
+
+                PostingList::Cursor cursor(p_Postings);
+                while (cursor.Next())
+                {
+                    leaf.Docs.push_back(cursor.GetDoc());
+                    leaf.Frequencies.push_back(cursor.GetFrequency());
+                }
+                return leaf;
+            }
+
+            // only the documents of p_Candidates that hold the term
+            Leaf MatchTerm(const PostingList& p_Postings, const DocSet& p_Candidates)
+            {
+                Leaf leaf;
+                leaf.DocCount = p_Postings.GetDocCount();
+
+                PostingList::Cursor cursor(p_Postings);
+                for (uint32_t doc : p_Candidates)
+                {
+                    if (!cursor.SkipTo(doc))
+                        break;
+
+                    if (cursor.GetDoc() == doc)
+                    {
+                        leaf.Docs.push_back(doc);
+                        leaf.Frequencies.push_back(cursor.GetFrequency());
+                    }
+                }
+                return leaf;
+            }
+
+            Leaf MatchPhrase(const QueryNode& p_Phrase)
+            {
+                Leaf leaf;
+
+                std::vector<PostingList::Cursor> cursors;
+                for (const auto& term : p_Phrase.Terms)
+                {
+                    const PostingList* postings = m_Index.FindPostings(term);
+                    if (!postings)
+                        return leaf;
+                    cursors.emplace_back(*postings);
+                }
+
+                std::vector<std::vector<uint32_t>> positions(cursors.size());
+
+                // leapfrog until every term sits on the same document
+                if (!cursors[0].Next())
+                    return leaf;
+
+                uint32_t doc = cursors[0].GetDoc();
+                while (true)
+                {
+                    bool aligned = true;
+                    for (auto& cursor : cursors)
+                    {
+                        if (!cursor.SkipTo(doc))
+                            return leaf;
+
+                        if (cursor.GetDoc() != doc)
+                        {
+                            doc = cursor.GetDoc();
+                            aligned = false;
+                            break;
+                        }
+                    }
+
+                    if (!aligned)
+                        continue;
+
+                    for (size_t i = 0; i < cursors.size(); i++)
+                        cursors[i].ReadPositions(positions[i]);
+
+                    uint32_t frequency = 0;
+                    for (uint32_t start : positions[0])
+                    {
+                        bool found = true;
+                        for (size_t i = 1; i < cursors.size() && found; i++)
+                            found = std::binary_search(positions[i].begin(), positions[i].end(), start + p_Phrase.Offsets[i]);
+
+                        frequency += found;
+                    }
+
+                    if (frequency > 0)
+                    {
+                        leaf.Docs.push_back(doc);
+                        leaf.Frequencies.push_back(frequency);
+                        leaf.DocCount++;
+                    }
+
+                    if (!cursors[0].Next())
+                        return leaf;
+                    doc = cursors[0].GetDoc();
+                }
+            }
+
+            DocSet GetAllDocs() const
+            {
+                DocSet docs(m_Index.GetDocCount());
+                for (uint32_t i = 0; i < (uint32_t)docs.size(); i++)
+                    docs[i] = i;
+                return docs;
+            }
+
+        private:
+            const InvertedIndex& m_Index;
+            std::vector<Leaf> m_Leaves;
+    };
+
+    uint32_t InvertedIndex::Add(const LawsuitView& p_Lawsuit)
+    {
+        uint32_t doc = (uint32_t)m_DocLengths.size();
+
+        m_Occurrences.clear();
+        uint32_t position = 0;
+        for (LawsuitField field : s_IndexedFields)
+        {
+            position += m_Tokenizer.Tokenize(p_Lawsuit[field], [&](std::string_view p_Token, uint32_t p_Position)
+            {
+                auto found = m_Terms.find(p_Token);
+                if (found == m_Terms.end())
+                {
+                    found = m_Terms.emplace(std::string(p_Token), (uint32_t)m_Postings.size()).first;
+                    m_Postings.emplace_back();
+                }
+
+                m_Occurrences.emplace_back(found->second, position + p_Position);
+            });
+
+            position += s_FieldGap;
+        }
+
+        // grouped by term, each term's positions ascending
+        std::sort(m_Occurrences.begin(), m_Occurrences.end());
+        for (size_t i = 0; i < m_Occurrences.size();)
+        {
+            uint32_t term = m_Occurrences[i].first;
+
+            m_Positions.clear();
+            for (; i < m_Occurrences.size() && m_Occurrences[i].first == term; i++)
+                m_Positions.push_back(m_Occurrences[i].second);
+
+            m_Postings[term].Add(doc, m_Positions.data(), (uint32_t)m_Positions.size());
+        }
+
+        m_DocLengths.push_back((uint32_t)m_Occurrences.size());
+        m_TotalLength += m_Occurrences.size();
+        return doc;
+    }
+
+    std::unique_ptr<InvertedIndex> InvertedIndex::Build(const Corpus& p_Corpus)
+    {
+        auto index = std::make_unique<InvertedIndex>();
+        for (size_t i = 0; i < p_Corpus.GetCount(); i++)
+            index->Add(p_Corpus.Get(i));
+
+        for (auto& postings : index->m_Postings)
+            postings.ShrinkToFit();
+        return index;
+    }
+
+    std::vector<SearchHit> InvertedIndex::Search(std::string_view p_Query, size_t p_Limit) const
+    {
+        // the stem cache only depends on the words, so every query of a thread shares one instead of clearing 256 KB each time
+        thread_local Tokenizer tokenizer;
+        std::optional<QueryNode> query = ParseQuery(p_Query, tokenizer);
+        if (!query || m_DocLengths.empty())
+            return {};
+
+        QueryEvaluator evaluator(*this);
+        DocSet matches = evaluator.Evaluate(*query, true);
+
+        // BM25 over every term and phrase the query asks for (not the excluded ones)
+        std::vector<float> scores(matches.size(), 0.0f);
+        float docCount = (float)m_DocLengths.size();
+        float averageLength = std::max(1.0f, float(m_TotalLength) / docCount);
+
+        for (const auto& leaf : evaluator.GetLeaves())
+        {
+            float frequency = (float)leaf.DocCount;
+            float idf = std::log(1.0f + (docCount - frequency + 0.5f) / (frequency + 0.5f));
+
+            size_t match = 0;
+            for (size_t i = 0; i < leaf.Docs.size() && match < matches.size(); i++)
+            {
+                while (match < matches.size() && matches[match] < leaf.Docs[i])
+                    match++;
+
+                if (match < matches.size() && matches[match] == leaf.Docs[i])
+                {
+                    float tf = (float)leaf.Frequencies[i];
+                    float norm = s_K1 * (1.0f - s_B + s_B * float(m_DocLengths[leaf.Docs[i]]) / averageLength);
+                    scores[match] += idf * tf * (s_K1 + 1.0f) / (tf + norm);
+                }
+            }
+        }
+
+        std::vector<SearchHit> hits(matches.size());
+        for (size_t i = 0; i < matches.size(); i++)
+            hits[i] = { matches[i], scores[i] };
+
+        auto better = [](const SearchHit& p_Left, const SearchHit& p_Right)
+        {
+            return p_Left.Score != p_Right.Score ? p_Left.Score > p_Right.Score : p_Left.Doc < p_Right.Doc;
+        };
+
+        size_t count = std::min(p_Limit, hits.size());
+        std::partial_sort(hits.begin(), hits.begin() + count, hits.end(), better);
+        hits.resize(count);
+        return hits;
+    }
+
+    size_t InvertedIndex::GetByteSize() const
+    {
+        size_t size = m_DocLengths.size() * sizeof(uint32_t);
+        for (const auto& postings : m_Postings)
+            size += postings.GetByteSize() + sizeof(PostingList);
+        for (const auto& [term, id] : m_Terms)
+            size += term.size() + sizeof(id);
+        return size;
+    }
+
+    const PostingList* InvertedIndex::FindPostings(std::string_view p_Term) const
+    {
+        auto found = m_Terms.find(p_Term);
+        return found != m_Terms.end() ? &m_Postings[found->second] : nullptr;
+    }
+
+} // namespace SCPY
@@ -0,0 +1,67 @@
+#pragma once
+#include "Core/Search.h"
+#include "Tokenizer.h"
+#include "PostingList.h"
+
+// std
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+
+namespace SCPY
+{
+    class Corpus;
+
+    struct SearchHit
+    {
+        uint32_t Doc = 0;
+        float Score = 0.0f;
+    };
+
+    // Full text index over the Case, Headnote and Decision of harvested records, ranked with BM25.
+    // Documents are numbered in the order they are added, for a Corpus that is the record's row.
+    class InvertedIndex
+    {
+        public:
+            uint32_t Add(const LawsuitView& p_Lawsuit);
+
+            static std::unique_ptr<InvertedIndex> Build(const Corpus& p_Corpus);
+
+            // Query in SCON's syntax (see ParseQuery), best matches first
+            std::vector<SearchHit> Search(std::string_view p_Query, size_t p_Limit = 100) const;
+
+            size_t GetDocCount() const { return m_DocLengths.size(); }
+            size_t GetTermCount() const { return m_Postings.size(); }
+            size_t GetByteSize() const;
+
+            static constexpr LawsuitField s_IndexedFields[] = { LawsuitField::Case, LawsuitField::Headnote, LawsuitField::Decision };
+
+        private:
+            const PostingList* FindPostings(std::string_view p_Term) const;
+
+            friend class QueryEvaluator;
+
+        private:
+            struct TermHash
+            {
+                using is_transparent = void;
+                size_t operator()(std::string_view p_Term) const { return std::hash<std::string_view>{}(p_Term); }
+            };
+
+            std::unordered_map<std::string, uint32_t, TermHash, std::equal_to<>> m_Terms;
+            std::vector<PostingList> m_Postings;
+
+            std::vector<uint32_t> m_DocLengths;
+            uint64_t m_TotalLength = 0;
+
+            Tokenizer m_Tokenizer;
+            std::vector<std::pair<uint32_t, uint32_t>> m_Occurrences; // term, position of the document being added
+            std::vector<uint32_t> m_Positions;
+    };
+
+} // namespace SCPY
@@ -0,0 +1,238 @@
+#include "PostingList.h"
+
+
+
+namespace SCPY
+{
+    namespace
+    {
+        void WriteVarint(std::vector<uint8_t>& p_Output, uint32_t p_Value)
+        {
+            while (p_Value >= 0x80)
+            {
+                p_Output.push_back(uint8_t(p_Value | 0x80));
+                p_Value >>= 7;
+            }
+            p_Output.push_back(uint8_t(p_Value));
+        }
+
+        uint32_t ReadVarint(const std::vector<uint8_t>& p_Input, size_t& p_Offset)
+        {
+            uint32_t value = 0;
+            for (int shift = 0; ; shift += 7)
+            {
+                uint8_t byte = p_Input[p_Offset++];
+                value |= uint32_t(byte & 0x7F) << shift;
+                if (byte < 0x80)
+                    return value;
+            }
+        }
+
+    } // namespace
+
+    void PostingList::Add(uint32_t p_Doc, const uint32_t* p_Positions, uint32_t p_Count)
+    {
+        if (m_TailCount == 0)
+            m_TailPositionOffset = (uint32_t)m_Positions.size();
+
+        uint32_t previous = m_DocCount == 0 ? UINT32_MAX : m_LastDoc;
+        WriteVarint(m_Tail, p_Doc - previous - 1);
+        WriteVarint(m_Tail, p_Count - 1);
+
+        uint32_t last = 0;
+        for (uint32_t i = 0; i < p_Count; i++)
+        {
+            WriteVarint(m_Positions, p_Positions[i] - last);
+            last = p_Positions[i];
+        }
+
+        m_LastDoc = p_Doc;
+        m_DocCount++;
+
+        if (++m_TailCount == s_PackedBlockSize)
+            FlushTail();
+    }
+
+    size_t PostingList::GetByteSize() const
+    {
+        return m_Blocks.size() + m_Skips.size() * (sizeof(Skip) + sizeof(uint32_t)) + m_Tail.size() + m_Positions.size();
+    }
+
+    void PostingList::ShrinkToFit()
+    {
+        m_Blocks.shrink_to_fit();
+        m_Skips.shrink_to_fit();
+        m_SkipDocs.shrink_to_fit();
+        m_Tail.shrink_to_fit();
+        m_Positions.shrink_to_fit();
+    }
+
+    void PostingList::FlushTail()
+    {
+        uint32_t gaps[s_PackedBlockSize];
+        uint32_t frequencies[s_PackedBlockSize];
+
+        size_t offset = 0;
+        for (size_t i = 0; i < s_PackedBlockSize; i++)
+        {
+            gaps[i] = ReadVarint(m_Tail, offset);
+            frequencies[i] = ReadVarint(m_Tail, offset);
+        }
+
+        Skip skip;
+        skip.Offset = (uint32_t)m_Blocks.size();
+        skip.PositionOffset = m_TailPositionOffset;
+        skip.DocBits = GetBitWidth(gaps, s_PackedBlockSize);
+        skip.FrequencyBits = GetBitWidth(frequencies, s_PackedBlockSize);
+
+        m_Blocks.resize(m_Blocks.size() + GetPackedByteSize(skip.DocBits) + GetPackedByteSize(skip.FrequencyBits));
+        PackBlock(gaps, skip.DocBits, m_Blocks.data() + skip.Offset);
+        PackBlock(frequencies, skip.FrequencyBits, m_Blocks.data() + skip.Offset + GetPackedByteSize(skip.DocBits));
+
+        m_Skips.push_back(skip);
+        m_SkipDocs.push_back(m_LastDoc);
+
+        m_Tail.clear();
+        m_TailCount = 0;
+    }
+
+    PostingList::Cursor::Cursor(const PostingList& p_List)
+        : m_List(p_List)
+    {
+    }
+
+    bool PostingList::Cursor::Next()
+    {
+        if (!m_Started)
+        {
+            m_Started = true;
+            return Load(0);
+        }
+
+        if (m_Index + 1 < m_Count)
+        {
+            m_Index++;
+            return true;
+        }
+
+        if (m_Block < m_List.m_Skips.size())
+            return Load(m_Block + 1);
+
+        m_Index = m_Count;
+        return false;
+    }
+
+    bool PostingList::Cursor::SkipTo(uint32_t p_Doc)
+    {
+        if (!m_Started && !Next())
+            return false;
+
+        if (m_Index >= m_Count)
+            return false;
+
+        if (m_Docs[m_Index] >= p_Doc)
+            return true;
+
+        // past this block, its skip entries tell which block holds p_Doc
+        if (m_Docs[m_Count - 1] < p_Doc)
+        {
+            size_t count = m_List.m_SkipDocs.size();
+            if (m_Block >= count)
+            {
+                m_Index = m_Count;
+                return false;
+            }
+
+            const uint32_t* lastDocs = m_List.m_SkipDocs.data();
+            if (!Load(size_t(Gallop(lastDocs + m_Block + 1, lastDocs + count, p_Doc) - lastDocs)))
+                return false;
+        }
+
+        m_Index = uint32_t(Gallop(m_Docs + m_Index, m_Docs + m_Count, p_Doc) - m_Docs);
+        return m_Index < m_Count;
+    }
+
+    uint32_t PostingList::Cursor::GetFrequency()
+    {
+        LoadFrequencies();
+        return m_Frequencies[m_Index];
+    }
+
+    void PostingList::Cursor::ReadPositions(std::vector<uint32_t>& p_Positions)
+    {
+        p_Positions.clear();
+        if (m_Index >= m_Count)
+            return;
+
+        LoadFrequencies();
+
+        // every varint ends on a byte below 0x80, positions of the documents passed are only counted over
+        const std::vector<uint8_t>& positions = m_List.m_Positions;
+        for (; m_PositionDoc < m_Index; m_PositionDoc++)
+        {
+            for (uint32_t i = 0; i < m_Frequencies[m_PositionDoc]; i++)
+            {
+                while (positions[m_PositionOffset++] >= 0x80) {}
+            }
+        }
+
+        size_t offset = m_PositionOffset;
+        uint32_t position = 0;
+        for (uint32_t i = 0; i < m_Frequencies[m_Index]; i++)
+        {
+            position += ReadVarint(positions, offset);
+            p_Positions.push_back(position);
+        }
+    }
+
+    bool PostingList::Cursor::Load(size_t p_Block)
+    {
+        m_Block = p_Block;
+        m_Index = 0;
+        m_PositionDoc = 0;
+
+        uint32_t previous = p_Block == 0 ? UINT32_MAX : m_List.m_SkipDocs[p_Block - 1];
+        if (p_Block < m_List.m_Skips.size())
+        {
+            const Skip& skip = m_List.m_Skips[p_Block];
+            const uint8_t* data = m_List.m_Blocks.data() + skip.Offset;
+
+            UnpackBlock(data, skip.DocBits, m_Docs);
+            DecodeGaps(m_Docs, s_PackedBlockSize, previous);
+
+            m_Count = (uint32_t)s_PackedBlockSize;
+            m_PositionOffset = skip.PositionOffset;
+            m_FrequenciesLoaded = false;
+        }
+        else
+        {
+            size_t offset = 0;
+            for (uint32_t i = 0; i < m_List.m_TailCount; i++)
+            {
+                previous += ReadVarint(m_List.m_Tail, offset) + 1;
+                m_Docs[i] = previous;
+                m_Frequencies[i] = ReadVarint(m_List.m_Tail, offset) + 1;
+            }
+
+            m_Count = m_List.m_TailCount;
+            m_PositionOffset = m_List.m_TailPositionOffset;
+            m_FrequenciesLoaded = true;
+        }
+
+        return m_Count > 0;
+    }
+
+    void PostingList::Cursor::LoadFrequencies()
+    {
+        if (m_FrequenciesLoaded)
+            return;
+
+        const Skip& skip = m_List.m_Skips[m_Block];
+        UnpackBlock(m_List.m_Blocks.data() + skip.Offset + GetPackedByteSize(skip.DocBits), skip.FrequencyBits, m_Frequencies);
+        for (uint32_t i = 0; i < m_Count; i++)
+            m_Frequencies[i]++;
+
+        m_FrequenciesLoaded = true;
+    }
+
+} // namespace SCPY
@@ -0,0 +1,109 @@
+#pragma once
+#include "BitPacking.h"
+
+// std
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+
+
+namespace SCPY
+{
+    // First element of the sorted range at or after p_Value: doubling steps from p_Begin, then a binary search
+    // inside the last step. Cheaper than lower_bound when the answer is usually close, as it is when merging.
+    inline const uint32_t* Gallop(const uint32_t* p_Begin, const uint32_t* p_End, uint32_t p_Value)
+    {
+        size_t size = size_t(p_End - p_Begin);
+        size_t low = 0, step = 1;
+        while (low + step < size && p_Begin[low + step] < p_Value)
+        {
+            low += step;
+            step *= 2;
+        }
+        return std::lower_bound(p_Begin + low, p_Begin + std::min(low + step + 1, size), p_Value);
+    }
+
+    // Documents of one term in ascending order, with the positions of the term in each of them.
+    // Documents and frequencies go in bit packed blocks of 128 with a skip entry per block (last document,
+    // where its data starts), the ones after the last full block wait as varints.
+    // Positions are delta coded varints in their own stream, so a walk that ignores them never touches them.
+    class PostingList
+    {
+        public:
+            // p_Doc must be above every document added before, p_Count at least 1
+            void Add(uint32_t p_Doc, const uint32_t* p_Positions, uint32_t p_Count);
+
+            uint32_t GetDocCount() const { return m_DocCount; }
+            size_t GetByteSize() const;
+
+            // Gives back what the vectors reserved for growth, once nothing more is added
+            void ShrinkToFit();
+
+            class Cursor
+            {
+                public:
+                    explicit Cursor(const PostingList& p_List);
+
+                    // Moves to the next document, false past the last one
+                    bool Next();
+
+                    // Moves to the first document at or after p_Doc, never backwards. Whole blocks are passed
+                    // on their skip entries without being unpacked.
+                    bool SkipTo(uint32_t p_Doc);
+
+                    // only valid after Next or SkipTo returned true
+                    uint32_t GetDoc() const { return m_Docs[m_Index]; }
+                    uint32_t GetFrequency();
+
+                    // Positions of the term in the current document, ascending
+                    void ReadPositions(std::vector<uint32_t>& p_Positions);
+
+                private:
+                    // Unpacks the documents of block p_Block, the varint tail when it is the block count
+                    bool Load(size_t p_Block);
+
+                    // Frequencies wait until a document is actually scored, most blocks an AND visits have no match
+                    void LoadFrequencies();
+
+                private:
+                    const PostingList& m_List;
+
+                    uint32_t m_Docs[s_PackedBlockSize];
+                    uint32_t m_Frequencies[s_PackedBlockSize];
+                    size_t m_Block = 0;
+                    uint32_t m_Count = 0;   // documents in the loaded block
+                    uint32_t m_Index = 0;   // m_Count once past the last document
+                    bool m_Started = false;
+                    bool m_FrequenciesLoaded = false;
+
+                    // positions of document m_PositionDoc of the block start there
+                    size_t m_PositionOffset = 0;
+                    uint32_t m_PositionDoc = 0;
+            };
+
+        private:
+            void FlushTail();
+
+        private:
+            struct Skip
+            {
+                uint32_t Offset = 0;            // in m_Blocks
+                uint32_t PositionOffset = 0;    // in m_Positions
+                uint8_t DocBits = 0;
+                uint8_t FrequencyBits = 0;
+            };
+
+            std::vector<uint8_t> m_Blocks;      // packed document gaps then packed frequencies - 1, per block
+            std::vector<Skip> m_Skips;
+            std::vector<uint32_t> m_SkipDocs;   // last document of each block, galloped over by SkipTo
+            std::vector<uint8_t> m_Tail;        // document gap, frequency - 1, as varints
+            uint32_t m_TailCount = 0;
+            uint32_t m_TailPositionOffset = 0;
+            std::vector<uint8_t> m_Positions;   // position gaps, frequency of them per document
+
+            uint32_t m_LastDoc = 0;
+            uint32_t m_DocCount = 0;
+    };
+
+} // namespace SCPY
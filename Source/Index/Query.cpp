@@ -0,0 +1,254 @@
+#include "Query.h"
+
+
+
+namespace SCPY
+{
+    namespace
+    {
+        enum class LexemeType : uint8_t
+        {
+            Word, Phrase, Open, Close, And, Or, Not
+        };
+
+        struct Lexeme
+        {
+            LexemeType Type;
+            std::string_view Text;
+        };
+
+        LexemeType ClassifyWord(std::string_view p_Word)
+        {
+            std::string word(p_Word);
+            for (char& c : word)
+            {
+                if (c >= 'A' && c <= 'Z')
+                    c = char(c - 'A' + 'a');
+            }
+
+            if (word == "e")
+                return LexemeType::And;
+            if (word == "ou")
+                return LexemeType::Or;
+            if (word == "n\xC3\xA3o" || word == "n\xC3\x83o" || word == "nao")
+                return LexemeType::Not;
+            return LexemeType::Word;
+        }
+
+        std::vector<Lexeme> Lex(std::string_view p_Query)
+        {
+            std::vector<Lexeme> lexemes;
+
+            size_t i = 0;
+            while (i < p_Query.size())
+            {
+                char c = p_Query[i];
+                if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+                {
+                    i++;
+                }
+                else if (c == '(' || c == ')')
+                {
+                    lexemes.push_back({ c == '(' ? LexemeType::Open : LexemeType::Close, p_Query.substr(i, 1) });
+                    i++;
+                }
+                else if (c == '"')
+                {
+                    // an unterminated quote runs to the end
+                    size_t end = p_Query.find('"', i + 1);
+                    if (end == std::string_view::npos)
+                        end = p_Query.size();
+
+                    lexemes.push_back({ LexemeType::Phrase, p_Query.substr(i + 1, end - i - 1) });
+                    i = end + 1;
+                }
+                else
+                {
+                    size_t end = p_Query.find_first_of(" \t\r\n()\"", i);
+                    if (end == std::string_view::npos)
+                        end = p_Query.size();
+
+                    std::string_view word = p_Query.substr(i, end - i);
+                    lexemes.push_back({ ClassifyWord(word), word });
+                    i = end;
+                }
+            }
+
+            return lexemes;
+        }
+
+        class Parser
+        {
+            public:
+                Parser(std::vector<Lexeme> p_Lexemes, Tokenizer& p_Tokenizer)
+                    : m_Lexemes(std::move(p_Lexemes)), m_Tokenizer(p_Tokenizer)
+                {
+                }
+
+                std::optional<QueryNode> ParseAll()
+                {
+                    std::optional<QueryNode> result;
+                    while (m_Next < m_Lexemes.size())
+                    {
+                        size_t start = m_Next;
+                        auto node = ParseOr();
+                        if (node)
+                            result = result ? Combine(QueryOp::And, std::move(*result), std::move(*node)) : std::move(node);
+
+                        // a stray ")" stops ParseOr where it is
+                        if (m_Next == start || (m_Next < m_Lexemes.size() && m_Lexemes[m_Next].Type == LexemeType::Close))
+                            m_Next++;
+                    }
+                    return result;
+                }
+
+            private:
+                std::optional<QueryNode> ParseOr()
+                {
+                    std::optional<QueryNode> left = ParseAnd();
+                    while (Accept(LexemeType::Or))
+                    {
+                        std::optional<QueryNode> right = ParseAnd();
+                        if (!right)
+                            continue;
+                        left = left ? Combine(QueryOp::Or, std::move(*left), std::move(*right)) : std::move(right);
+                    }
+                    return left;
+                }
+
+                // "e" is implied between neighbours
+                std::optional<QueryNode> ParseAnd()
+                {
+                    std::optional<QueryNode> left;
+                    while (m_Next < m_Lexemes.size())
+                    {
+                        LexemeType type = m_Lexemes[m_Next].Type;
+                        if (type == LexemeType::Or || type == LexemeType::Close)
+                            break;
+
+                        if (type == LexemeType::And)
+                        {
+                            m_Next++;
+                            continue;
+                        }
+
+                        std::optional<QueryNode> right = ParseUnary();
+                        if (!right)
+                            continue;
+                        left = left ? Combine(QueryOp::And, std::move(*left), std::move(*right)) : std::move(right);
+                    }
+                    return left;
+                }
+
+                std::optional<QueryNode> ParseUnary()
+                {
+                    if (!Accept(LexemeType::Not))
+                        return ParsePrimary();
+
+                    std::optional<QueryNode> operand = ParseUnary();
+                    if (!operand)
+                        return std::nullopt;
+
+                    // "não não x" is just x
+                    if (operand->Op == QueryOp::Not)
+                        return std::move(operand->Children.front());
+
+                    QueryNode node;
+                    node.Op = QueryOp::Not;
+                    node.Children.push_back(std::move(*operand));
+                    return node;
+                }
+
+                std::optional<QueryNode> ParsePrimary()
+                {
+                    if (m_Next >= m_Lexemes.size())
+                        return std::nullopt;
+
+                    const Lexeme& lexeme = m_Lexemes[m_Next++];
+                    switch (lexeme.Type)
+                    {
+                        case LexemeType::Open:
+                        {
+                            std::optional<QueryNode> inner = ParseOr();
+                            Accept(LexemeType::Close);
+                            return inner;
+                        }
+
+                        case LexemeType::Word:
+                        case LexemeType::Phrase:
+                            return MakeLeaf(lexeme.Text);
+
+                        default:
+                            return std::nullopt;
+                    }
+                }
+
+                // a word the tokenizer splits (ex: "art.5") has to match as a phrase
+                std::optional<QueryNode> MakeLeaf(std::string_view p_Text)
+                {
+                    QueryNode node;
+                    m_Tokenizer.Tokenize(p_Text, [&](std::string_view p_Token, uint32_t p_Position)
+                    {
+                        node.Terms.emplace_back(p_Token);
+                        node.Offsets.push_back(p_Position);
+                    });
+
+                    if (node.Terms.empty())
+                        return std::nullopt;
+
+                    if (node.Terms.size() == 1)
+                    {
+                        node.Offsets.clear();
+                        return node;
+                    }
+
+                    node.Op = QueryOp::Phrase;
+                    uint32_t first = node.Offsets.front();
+                    for (uint32_t& offset : node.Offsets)
+                        offset -= first;
+                    return node;
+                }
+
+                static QueryNode Combine(QueryOp p_Op, QueryNode p_Left, QueryNode p_Right)
+                {
+                    // flattens "a e b e c" into a single node
+                    QueryNode node;
+                    node.Op = p_Op;
+                    for (QueryNode* side : { &p_Left, &p_Right })
+                    {
+                        if (side->Op == p_Op)
+                        {
+                            for (auto& child : side->Children)
+                                node.Children.push_back(std::move(child));
+                        }
+                        else
+                            node.Children.push_back(std::move(*side));
+                    }
+                    return node;
+                }
+
+                bool Accept(LexemeType p_Type)
+                {
+                    if (m_Next < m_Lexemes.size() && m_Lexemes[m_Next].Type == p_Type)
+                    {
+                        m_Next++;
+                        return true;
+                    }
+                    return false;
+                }
+
+            private:
+                std::vector<Lexeme> m_Lexemes;
+                size_t m_Next = 0;
+                Tokenizer& m_Tokenizer;
+        };
+
+    } // namespace
+
+    std::optional<QueryNode> ParseQuery(std::string_view p_Query, Tokenizer& p_Tokenizer)
+    {
+        Parser parser(Lex(p_Query), p_Tokenizer);
+        return parser.ParseAll();
+    }
+
+} // namespace SCPY
@@ -0,0 +1,33 @@
+#pragma once
+#include "Tokenizer.h"
+
+// std
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+
+namespace SCPY
+{
+    enum class QueryOp : uint8_t
+    {
+        Term, Phrase, And, Or, Not
+    };
+
+    struct QueryNode
+    {
+        QueryOp Op = QueryOp::Term;
+        std::vector<std::string> Terms;     // one for Term, in order for Phrase
+        std::vector<uint32_t> Offsets;      // Phrase only, each term's distance from the first (dropped stopwords leave gaps)
+        std::vector<QueryNode> Children;    // And and Or have two or more, Not has one
+    };
+
+    // SCON's pesquisa livre syntax: words are joined by "e" (and) unless "ou" (or) joins them,
+    // "não" excludes what follows, quotes make a phrase and parentheses group.
+    // Words go through p_Tokenizer like the indexed text did. Empty when nothing searchable is left.
+    std::optional<QueryNode> ParseQuery(std::string_view p_Query, Tokenizer& p_Tokenizer);
+
+} // namespace SCPY
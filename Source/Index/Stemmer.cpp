@@ -0,0 +1,327 @@
+#include "Stemmer.h"
+
+// std
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+
+
+namespace SCPY
+{
+    namespace
+    {
+        struct StemRule
+        {
+            std::string_view Suffix;
+            uint8_t MinStem = 0; // letters that have to stay in front of the suffix
+            std::string_view Replacement = "";
+            std::vector<std::string_view> Exceptions = {};
+        };
+
+        // The rules of one RSLP step laid out flat and grouped by the word's last two letters,
+        // longest suffix first, so a step looks at a handful of rules at most
+        class StemStep
+        {
+            public:
+                StemStep(std::vector<StemRule> p_Rules)
+                    : m_Rules(std::move(p_Rules))
+                {
+                    std::stable_sort(m_Rules.begin(), m_Rules.end(), [](const StemRule& p_Left, const StemRule& p_Right)
+                    {
+                        return p_Left.Suffix.size() > p_Right.Suffix.size();
+                    });
+
+                    std::array<std::vector<CompiledRule>, s_EndingCount> endings;
+                    for (size_t i = 0; i < m_Rules.size(); i++)
+                    {
+                        const StemRule& rule = m_Rules[i];
+
+                        CompiledRule compiled;
+                        std::memcpy(compiled.Suffix, rule.Suffix.data(), rule.Suffix.size());
+                        std::memcpy(compiled.Replacement, rule.Replacement.data(), rule.Replacement.size());
+                        compiled.SuffixSize = (uint8_t)rule.Suffix.size();
+                        compiled.MinSize = uint8_t(rule.Suffix.size() + rule.MinStem);
+                        compiled.ReplacementSize = (uint8_t)rule.Replacement.size();
+                        compiled.Rule = (uint16_t)i;
+
+                        size_t last = size_t(rule.Suffix.back() - 'a') * 26;
+                        if (rule.Suffix.size() == 1)
+                        {
+                            for (size_t before = 0; before < 26; before++)
+                                endings[last + before].push_back(compiled);
+                        }
+                        else
+                            endings[last + size_t(rule.Suffix[rule.Suffix.size() - 2] - 'a')].push_back(compiled);
+                    }
+
+                    for (size_t ending = 0; ending < s_EndingCount; ending++)
+                    {
+                        m_Offsets[ending] = (uint16_t)m_Compiled.size();
+                        m_Compiled.insert(m_Compiled.end(), endings[ending].begin(), endings[ending].end());
+                    }
+                    m_Offsets[s_EndingCount] = (uint16_t)m_Compiled.size();
+                }
+
+                // the first rule that fits wins, one that matches but doesn't fit lets the next one try
+                bool Apply(char* p_Word, size_t& p_Size) const
+                {
+                    if (p_Size < 2)
+                        return false;
+
+                    unsigned last = unsigned(p_Word[p_Size - 1] - 'a');
+                    unsigned before = unsigned(p_Word[p_Size - 2] - 'a');
+                    if (last >= 26 || before >= 26)
+                        return false;
+
+                    size_t ending = last * 26 + before;
+                    for (size_t i = m_Offsets[ending]; i < m_Offsets[ending + 1]; i++)
+                    {
+                        const CompiledRule& rule = m_Compiled[i];
+                        if (p_Size < rule.MinSize)
+                            continue;
+
+                        // the last two letters already match
+                        const char* tail = p_Word + p_Size - rule.SuffixSize;
+                        bool match = true;
+                        for (size_t c = 0; c + 2 < rule.SuffixSize && match; c++)
+                            match = tail[c] == rule.Suffix[c];
+                        if (!match)
+                            continue;
+
+                        const auto& exceptions = m_Rules[rule.Rule].Exceptions;
+                        if (std::find(exceptions.begin(), exceptions.end(), std::string_view(p_Word, p_Size)) != exceptions.end())
+                            continue;
+
+                        std::memcpy(p_Word + p_Size - rule.SuffixSize, rule.Replacement, rule.ReplacementSize);
+                        p_Size = p_Size - rule.SuffixSize + rule.ReplacementSize;
+                        return true;
+                    }
+                    return false;
+                }
+
+            private:
+                struct CompiledRule
+                {
+                    char Suffix[12] = {};
+                    char Replacement[4] = {};
+                    uint8_t SuffixSize = 0;
+                    uint8_t MinSize = 0; // suffix and stem
+                    uint8_t ReplacementSize = 0;
+                    uint16_t Rule = 0;
+                };
+
+                static constexpr size_t s_EndingCount = 26 * 26;
+
+                std::vector<StemRule> m_Rules;
+                std::vector<CompiledRule> m_Compiled;
+                std::array<uint16_t, s_EndingCount + 1> m_Offsets = {}; // m_Compiled range of each ending, by last letter then the one before
+        };
+
+        // RSLP's rules with the accents folded, merged where two only differed by an accent
+        struct StemSteps
+        {
+            StemStep Plural =
+            {{
+                { "ns", 1, "m" },
+                { "oes", 1, "ao" },
+                { "aes", 1, "ao", { "maes" } },
+                { "ais", 1, "al", { "cais", "mais", "pais", "jamais", "demais" } },
+                { "eis", 2, "el" },
+                { "ois", 2, "ol", { "dois", "pois", "depois" } },
+                { "is", 2, "il", { "lapis", "cais", "mais", "crucis", "biquinis", "pois", "depois", "dois", "leis", "reis", "seis", "tenis", "oasis", "pais", "jamais", "demais" } },
+                { "les", 3, "l" },
+                { "res", 3, "r", { "arvores" } },
+                { "s", 2, "", { "alias", "pires", "lapis", "cais", "mais", "mas", "menos", "ferias", "fezes", "pesames", "crucis", "gas", "atras", "moises",
+                    "atraves", "conves", "pais", "apos", "ambas", "ambos", "messias", "depois", "onibus", "virus", "bonus", "tenis", "jamais", "demais", "tres", "simples" } },
+            }};
+
+            StemStep Feminine =
+            {{
+                { "ona", 3, "ao", { "abandona", "lona", "iona", "cortisona", "monotona", "maratona", "acetona", "detona", "carona" } },
+                { "ora", 3, "or", { "demora", "decora", "agora", "embora", "ignora", "melhora", "piora" } },
+                { "na", 4, "no", { "carona", "abandona", "lona", "regina", "platina", "sabatina", "vitamina", "disciplina", "oficina", "cortina",
+                    "medicina", "doutrina", "pagina", "rotina", "vacina", "maquina", "semana", "campana", "antena", "arena", "coluna", "fortuna" } },
+                { "inha", 3, "inho", { "rainha", "linha", "minha" } },
+                { "esa", 3, "es", { "mesa", "obesa", "princesa", "turquesa", "ilesa", "pesa", "presa", "defesa", "despesa", "empresa", "represa",
+                    "surpresa", "sobremesa", "framboesa" } },
+                { "osa", 3, "oso", { "mucosa", "prosa" } },
+                { "iaca", 3, "iaco", { "maniaca" } },
+                { "ica", 3, "ico", { "dica" } },
+                { "ada", 2, "ado", { "pitada" } },
+                { "ida", 3, "ido", { "vida", "divida", "guarida" } },
+                { "ima", 3, "imo", { "vitima", "lagrima" } },
+                { "iva", 3, "ivo", { "saliva", "oliva" } },
+                { "eira", 3, "eiro", { "beira", "cadeira", "frigideira", "bandeira", "feira", "capoeira", "barreira", "fronteira", "besteira", "poeira" } },
+            }};
+
+            StemStep Adverb =
+            {{
+                { "mente", 4, "", { "experimente" } },
+            }};
+
+            StemStep Augmentative =
+            {{
+                { "dissimo", 5 },
+                { "abilissimo", 5 },
+                { "issimo", 3 },
+                { "esimo", 3 },
+                { "errimo", 4 },
+                { "zinho", 2 },
+                { "quinho", 4, "c" },
+                { "uinho", 4 },
+                { "adinho", 3 },
+                { "inho", 3, "", { "caminho", "cominho", "vizinho", "carinho", "sozinho", "vinho", "espinho", "moinho", "pinho", "linho", "ninho", "mesquinho" } },
+                { "alhao", 4 },
+                { "uca", 4 },
+                { "aco", 4, "", { "antebraco" } },
+                { "aca", 4 },
+                { "adao", 4 },
+                { "idao", 4 },
+                { "azio", 3, "", { "corredio" } },
+                { "arraz", 4 },
+                { "zarrao", 3 },
+                { "arrao", 4 },
+                { "zao", 2, "", { "coalizao", "razao" } },
+            }};
+
+            StemStep Noun =
+            {{
+                { "encialista", 4 },
+                { "alista", 5 },
+                { "agem", 3, "", { "coragem", "chantagem", "vantagem", "carruagem" } },
+                { "iamento", 4 },
+                { "amento", 3, "", { "firmamento", "fundamento", "departamento" } },
+                { "imento", 3 },
+                { "mento", 6, "", { "firmamento", "elemento", "complemento", "instrumento", "departamento" } },
+                { "alizado", 4 },
+                { "atizado", 4 },
+                { "tizado", 4, "", { "alfabetizado" } },
+                { "izado", 5, "", { "organizado", "pulverizado" } },
+                { "ativo", 4, "", { "pejorativo", "relativo" } },
+                { "tivo", 4, "", { "relativo" } },
+                { "ivo", 4, "", { "passivo", "possessivo", "pejorativo", "positivo" } },
+                { "ado", 2, "", { "grado" } },
+                { "ido", 3, "", { "candido", "consolido", "rapido", "decido", "timido", "duvido", "marido" } },
+                { "ador", 3 },
+                { "edor", 3 },
+                { "idor", 4, "", { "ouvidor" } },
+                { "dor", 4, "", { "ouvidor" } },
+                { "sor", 4, "", { "assessor" } },
+                { "atoria", 5 },
+                { "tor", 3, "", { "benfeitor", "leitor", "editor", "pastor", "produtor", "promotor", "consultor" } },
+                { "ario", 3, "", { "voluntario", "salario", "aniversario", "diario", "lionario", "armario" } },
+                { "atorio", 3 },
+                { "abilidade", 5 },
+                { "ividade", 5 },
+                { "idade", 4, "", { "autoridade", "comunidade" } },
+                { "izacao", 5, "", { "organizacao" } },
+                { "acao", 3, "", { "equacao" } },
+                { "encia", 3 },
+                { "ismo", 3, "", { "cinismo" } },
+                { "eza", 3 },
+                { "ez", 4 },
+                { "ico", 4, "", { "tico", "publico", "explico" } },
+                { "ional", 4 },
+                { "al", 4, "", { "afinal", "animal", "estatal", "bissexual", "desleal", "fiscal", "formal", "pessoal", "liberal", "postal", "virtual",
+                    "visual", "pontual", "sideral", "sucursal" } },
+                { "avel", 2, "", { "agradavel" } },
+                { "ivel", 5, "", { "possivel" } },
+                { "vel", 5, "", { "possivel" } },
+                { "bil", 3, "vel" },
+                { "ante", 2, "", { "gigante", "elefante", "adiante", "possante", "instante", "restaurante" } },
+                { "esco", 4 },
+            }};
+
+            StemStep Verb =
+            {{
+                { "ariamo", 2 }, { "assemo", 2 }, { "eriamo", 2 }, { "essemo", 2 }, { "iriamo", 3 }, { "issemo", 3 },
+                { "aramo", 2 }, { "aremo", 2 }, { "ariam", 2 }, { "ariei", 2 }, { "assei", 2 }, { "assem", 2 }, { "avamo", 2 },
+                { "eramo", 3 }, { "eremo", 3 }, { "eriam", 3 }, { "eriei", 3 }, { "essei", 3 }, { "essem", 3 },
+                { "iramo", 3 }, { "iremo", 3 }, { "iriam", 3 }, { "iriei", 3 }, { "issei", 3 }, { "issem", 3 },
+                { "tizar", 4, "", { "alfabetizar" } },
+                { "ando", 2 }, { "endo", 3 }, { "indo", 3 }, { "ondo", 3 },
+                { "aram", 2 }, { "arao", 2 }, { "arde", 2 }, { "arei", 2 }, { "arem", 2 }, { "aria", 2 }, { "armo", 2 }, { "asse", 2 }, { "aste", 2 },
+                { "avam", 2, "", { "agravam" } }, { "avei", 2 },
+                { "eram", 3 }, { "erao", 3 }, { "erde", 3 }, { "erei", 3 }, { "erem", 3 }, { "eria", 3 }, { "ermo", 3 }, { "esse", 3 },
+                { "este", 3, "", { "faroeste", "agreste" } },
+                { "iamo", 3 }, { "iram", 3 }, { "irao", 2 }, { "irde", 2 },
+                { "irei", 3, "", { "admirei" } }, { "irem", 3, "", { "adquirem" } },
+                { "iria", 3 }, { "irmo", 3 }, { "isse", 3 }, { "iste", 4 },
+                { "iava", 4, "", { "ampliava" } },
+                { "izar", 5, "", { "organizar" } },
+                { "itar", 5, "", { "acreditar", "explicitar", "estreitar" } },
+                { "guem", 3 },
+                { "amo", 2 }, { "iona", 3 },
+                { "ara", 2, "", { "arara", "prepara" } },
+                { "are", 2, "", { "prepare" } },
+                { "ava", 2, "", { "agrava" } },
+                { "emo", 2 },
+                { "era", 3, "", { "acelera", "espera" } },
+                { "ere", 3, "", { "espere" } },
+                { "iam", 3, "", { "enfiam", "ampliam", "elogiam", "ensaiam" } },
+                { "iei", 3 },
+                { "imo", 3, "", { "reprimo", "intimo", "nimo", "queimo", "ximo" } },
+                { "ira", 3, "", { "fronteira", "satira" } },
+                { "ire", 3, "", { "adquire" } },
+                { "omo", 3 },
+                { "ear", 4, "", { "alardear", "nuclear" } },
+                { "uei", 3 },
+                { "uia", 5 },
+                { "eou", 5 },
+                { "ai", 2 },
+                { "am", 2 },
+                { "ar", 2, "", { "azar", "bazaar", "patamar" } },
+                { "ei", 3 },
+                { "em", 2, "", { "alem", "virgem" } },
+                { "er", 2, "", { "eter", "pier" } },
+                { "eu", 3, "", { "chapeu" } },
+                { "ia", 3, "", { "estoria", "fatia", "acia", "praia", "elogia", "mania", "labia", "aprecia", "policia", "magia" } },
+                { "ir", 3, "", { "freir" } },
+                { "iu", 3 },
+                { "ou", 3 },
+                { "i", 3 },
+            }};
+
+            StemStep Vowel =
+            {{
+                { "gue", 2, "g", { "gangue", "jegue" } },
+                { "ao", 0, "ao" }, // a folded "ão" keeps its vowels, "acórdão" is not "acorda"
+                { "a", 3 },
+                { "e", 3 },
+                { "o", 3 },
+            }};
+        };
+
+        const StemSteps& GetSteps()
+        {
+            static const StemSteps s_Steps;
+            return s_Steps;
+        }
+
+    } // namespace
+
+    size_t StemPortuguese(char* p_Word, size_t p_Size)
+    {
+        if (p_Size < 3)
+            return p_Size;
+
+        const StemSteps& steps = GetSteps();
+        if (p_Word[p_Size - 1] == 's')
+            steps.Plural.Apply(p_Word, p_Size);
+        if (p_Word[p_Size - 1] == 'a')
+            steps.Feminine.Apply(p_Word, p_Size);
+
+        steps.Adverb.Apply(p_Word, p_Size);
+        steps.Augmentative.Apply(p_Word, p_Size);
+
+        if (!steps.Noun.Apply(p_Word, p_Size) && !steps.Verb.Apply(p_Word, p_Size))
+            steps.Vowel.Apply(p_Word, p_Size);
+
+        return p_Size;
+    }
+
+} // namespace SCPY
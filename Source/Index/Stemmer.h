@@ -0,0 +1,16 @@
+#pragma once
+
+// std
+#include <cstddef>
+
+
+
+namespace SCPY
+{
+    // RSLP (Orengo & Huyck) style suffix stripping for Portuguese: plural, feminine, adverb,
+    // augmentative, then noun or verb suffixes, else the final vowel.
+    // p_Word is lower case a-z with the accents already folded away, the rules are written for that.
+    // Stems in place and returns the new size, never longer than p_Size.
+    size_t StemPortuguese(char* p_Word, size_t p_Size);
+
+} // namespace SCPY
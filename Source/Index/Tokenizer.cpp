@@ -0,0 +1,195 @@
+#include "Tokenizer.h"
+#include "Stemmer.h"
+
+// std
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+
+
+namespace SCPY
+{
+    namespace
+    {
+        // What a two byte UTF-8 sequence (U+0080 to U+017F) becomes inside a word.
+        // Empty is a separator, s_Skip is dropped without ending the word.
+        struct Folding
+        {
+            char Text[3] = {};
+        };
+
+        constexpr char s_Skip = '\x01';
+
+        // U+0080 to U+017F, one letter each. Past U+00BF the digits stand for two letter foldings (æ, þ, ß, ĳ, œ)
+        constexpr std::string_view s_LatinLetters =
+            // U+0080 - U+00BF: symbols, besides the ordinals, superscripts and the soft hyphen
+            "________________________________"
+            "__________a__-____23_____1o_____"
+            // U+00C0 - U+00FF
+            "aaaaaa1ceeeeiiiidnooooo_ouuuuy23"
+            "aaaaaa1ceeeeiiiidnooooo_ouuuuy2y"
+            // U+0100 - U+017F
+            "aaaaaaccccccccddddeeeeeeeeeegggggggghhhhiiiiiiiiii44jjkkkllllllllllnnnnnnnnnoooooo55rrrrrrssssssssttttttuuuuuuuuuuuuwwyyyzzzzzzs";
+
+        static_assert(s_LatinLetters.size() == 0x100);
+
+        constexpr std::array<Folding, 0x100> s_LatinFold = []()
+        {
+            std::array<Folding, 0x100> table{};
+            for (size_t i = 0; i < table.size(); i++)
+            {
+                auto set = [&](const char* p_Text)
+                {
+                    for (size_t c = 0; p_Text[c] != '\0'; c++)
+                        table[i].Text[c] = p_Text[c];
+                };
+
+                switch (char letter = s_LatinLetters[i])
+                {
+                    case '_': break;
+                    case '-': set("\x01"); break;
+                    case '1': set(i < 0x40 ? "1" : "ae"); break;
+                    case '2': set(i < 0x40 ? "2" : "th"); break;
+                    case '3': set(i < 0x40 ? "3" : "ss"); break;
+                    case '4': set("ij"); break;
+                    case '5': set("oe"); break;
+                    default:
+                    {
+                        const char text[2] = { letter, '\0' };
+                        set(text);
+                    }
+                }
+            }
+            return table;
+        }();
+
+        // Stopwords after folding, packed into integers so a lookup is a binary search over numbers.
+        // "não" stays a word, "recurso não conhecido" means something different without it.
+        constexpr std::string_view s_Stopwords[] =
+        {
+            "a", "o", "e", "as", "os", "ao", "aos", "da", "das", "do", "dos", "de", "em", "na", "nas", "no", "nos", "num", "numa",
+            "um", "uma", "uns", "umas", "para", "pra", "por", "pelo", "pela", "pelos", "pelas", "com", "sem", "sob", "sobre", "ate",
+            "apos", "entre", "contra", "desde", "perante", "que", "se", "ou", "mas", "nem", "como", "quando", "onde", "quem", "qual",
+            "quais", "cujo", "cuja", "cujos", "cujas", "porque", "pois", "ja", "ainda", "tambem", "so", "mais", "muito", "muitos",
+            "muita", "muitas", "tal", "tais", "isso", "isto", "aquilo", "esse", "essa", "esses", "essas", "este", "esta", "estes",
+            "estas", "aquele", "aquela", "aqueles", "aquelas", "ele", "ela", "eles", "elas", "eu", "tu", "voce", "voces", "me",
+            "te", "lhe", "lhes", "vos", "seu", "sua", "seus", "suas", "meu", "minha", "meus", "minhas", "teu", "tua", "teus",
+            "tuas", "nosso", "nossa", "nossos", "nossas", "dele", "dela", "deles", "delas", "foi", "foram", "ser", "sao", "era",
+            "eram", "sera", "seria", "seja", "sejam", "fosse", "tem", "ter", "tinha", "tendo", "sido", "estar", "estao", "estava",
+            "ha", "havia", "houve",
+        };
+
+        constexpr uint64_t Pack(const char* p_Word, size_t p_Size)
+        {
+            uint64_t key = 0;
+            for (size_t i = 0; i < p_Size; i++)
+                key |= uint64_t(uint8_t(p_Word[i])) << (i * 8);
+            return key;
+        }
+
+        constexpr auto s_StopwordKeys = []()
+        {
+            std::array<uint64_t, std::size(s_Stopwords)> keys{};
+            for (size_t i = 0; i < keys.size(); i++)
+                keys[i] = Pack(s_Stopwords[i].data(), s_Stopwords[i].size());
+            std::sort(keys.begin(), keys.end());
+            return keys;
+        }();
+
+        bool IsStopword(const char* p_Word, size_t p_Size)
+        {
+            return p_Size <= sizeof(uint64_t) && std::binary_search(s_StopwordKeys.begin(), s_StopwordKeys.end(), Pack(p_Word, p_Size));
+        }
+
+    } // namespace
+
+    bool Tokenizer::FoldSequence(const uint8_t*& p_Text, const uint8_t* p_End, size_t& p_Size, bool& p_Letters)
+    {
+        uint8_t lead = p_Text[0];
+        size_t length = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+
+        // stray continuation bytes, overlong leads and cut sequences end the word
+        bool valid = length > 1 && lead >= 0xC2 && lead <= 0xF4 && (size_t)(p_End - p_Text) >= length;
+        for (size_t i = 1; valid && i < length; i++)
+            valid = (p_Text[i] & 0xC0) == 0x80;
+
+        if (!valid)
+        {
+            p_Text++;
+            return false;
+        }
+
+        const uint8_t* sequence = p_Text;
+        p_Text += length;
+
+        uint32_t codepoint = length == 2 ? uint32_t(lead & 0x1F) << 6 | (sequence[1] & 0x3F)
+                           : length == 3 ? uint32_t(lead & 0x0F) << 12 | uint32_t(sequence[1] & 0x3F) << 6 | (sequence[2] & 0x3F)
+                           : 0x10000;
+
+        if (codepoint < 0x180)
+        {
+            const Folding& folding = s_LatinFold[codepoint - 0x80];
+            if (folding.Text[0] == '\0')
+                return false;
+            if (folding.Text[0] == s_Skip)
+                return true;
+
+            size_t size = folding.Text[1] == '\0' ? 1 : 2;
+            if (p_Size + size <= s_MaxWordSize)
+            {
+                std::memcpy(m_Word + p_Size, folding.Text, size);
+                p_Size += size;
+            }
+            p_Letters &= folding.Text[0] >= 'a';
+            return true;
+        }
+
+        // combining accents of decomposed text and zero width joiners vanish
+        if ((codepoint >= 0x300 && codepoint < 0x370) || (codepoint >= 0x200B && codepoint <= 0x200D) || codepoint == 0x2060)
+            return true;
+
+        // punctuation, quotes, dashes, symbols and the byte order mark
+        if ((codepoint >= 0x2000 && codepoint < 0x3000) || codepoint == 0xFEFF)
+            return false;
+
+        // any other script is kept as it is, without stemming
+        if (p_Size + length <= s_MaxWordSize)
+        {
+            std::memcpy(m_Word + p_Size, sequence, length);
+            p_Size += length;
+        }
+        p_Letters = false;
+        return true;
+    }
+
+    std::string_view Tokenizer::Normalize(size_t p_Size, bool p_Letters)
+    {
+        if (!p_Letters)
+            return std::string_view(m_Word, p_Size);
+
+        // too long to be a stopword or to be cached
+        if (p_Size > sizeof(CachedStem::Word))
+            return std::string_view(m_Word, StemPortuguese(m_Word, p_Size));
+
+        if (m_Stems.empty())
+            m_Stems.resize(s_StemCacheSize);
+
+        uint64_t hash = 0xCBF29CE484222325;
+        for (size_t i = 0; i < p_Size; i++)
+            hash = (hash ^ uint8_t(m_Word[i])) * 0x100000001B3;
+
+        CachedStem& cached = m_Stems[hash & (s_StemCacheSize - 1)];
+        if (cached.WordSize != p_Size || std::memcmp(cached.Word, m_Word, p_Size) != 0)
+        {
+            cached.WordSize = (uint8_t)p_Size;
+            std::memcpy(cached.Word, m_Word, p_Size);
+
+            cached.StemSize = IsStopword(m_Word, p_Size) ? 0 : (uint8_t)StemPortuguese(m_Word, p_Size);
+            std::memcpy(cached.Stem, m_Word, cached.StemSize);
+        }
+
+        return std::string_view(cached.Stem, cached.StemSize);
+    }
+
+} // namespace SCPY
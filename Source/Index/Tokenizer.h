@@ -0,0 +1,110 @@
+#pragma once
+
+// std
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+
+
+namespace SCPY
+{
+    // Splits UTF-8 text into index terms: case and accents are folded ("Indenizações" and
+    // "indenizacoes" both become "indenizacoes"), Portuguese stopwords are dropped and the
+    // remaining words are stemmed with StemPortuguese. Words with digits are kept as folded.
+    // ASCII goes through a single table lookup per byte, only bytes above 0x7F leave that path.
+    class Tokenizer
+    {
+        public:
+            // p_Callback(std::string_view p_Token, uint32_t p_Position) for every word kept, the view only lives during the call.
+            // Positions count the dropped stopwords too, so phrases keep their gaps. Returns how many words were seen.
+            template<typename F>
+            uint32_t Tokenize(std::string_view p_Text, F&& p_Callback)
+            {
+                const uint8_t* text = (const uint8_t*)p_Text.data();
+                const uint8_t* end = text + p_Text.size();
+
+                uint32_t position = 0;
+                size_t size = 0;
+                bool letters = true;
+
+                while (true)
+                {
+                    bool inWord = false;
+                    if (text < end)
+                    {
+                        uint8_t folded = s_AsciiFold[*text];
+                        if (folded != 0)
+                        {
+                            if (size < s_MaxWordSize)
+                                m_Word[size++] = (char)folded;
+                            letters &= folded >= 'a';
+                            text++;
+                            continue;
+                        }
+
+                        if (*text < 0x80)
+                            text++;
+                        else
+                            inWord = FoldSequence(text, end, size, letters);
+                    }
+
+                    if ((!inWord || text >= end) && size > 0)
+                    {
+                        std::string_view token = Normalize(size, letters);
+                        if (!token.empty())
+                            p_Callback(token, position);
+
+                        position++;
+                        size = 0;
+                        letters = true;
+                    }
+
+                    if (text >= end)
+                        return position;
+                }
+            }
+
+            // longer words are cut, they are never real words anyway
+            static constexpr size_t s_MaxWordSize = 64;
+
+        private:
+            // Folds the UTF-8 sequence at p_Text into m_Word and moves past it, false when it separates words
+            bool FoldSequence(const uint8_t*& p_Text, const uint8_t* p_End, size_t& p_Size, bool& p_Letters);
+
+            // The stem of the word in m_Word, empty for a stopword
+            std::string_view Normalize(size_t p_Size, bool p_Letters);
+
+        private:
+            // Most of a text is a small vocabulary, so stems are remembered in a direct mapped table
+            struct CachedStem
+            {
+                uint8_t WordSize = 0; // 0 for an empty slot
+                uint8_t StemSize = 0; // 0 for a stopword
+                char Word[15];
+                char Stem[15];
+            };
+
+            static constexpr size_t s_StemCacheSize = 8192;
+
+            // lower case letters and digits, 0 for separators and every byte above 0x7F
+            static constexpr std::array<uint8_t, 256> s_AsciiFold = []()
+            {
+                std::array<uint8_t, 256> table{};
+                for (int c = 0; c < 0x80; c++)
+                {
+                    if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z'))
+                        table[c] = (uint8_t)c;
+                    else if (c >= 'A' && c <= 'Z')
+                        table[c] = (uint8_t)(c - 'A' + 'a');
+                }
+                return table;
+            }();
+
+            char m_Word[s_MaxWordSize];
+            std::vector<CachedStem> m_Stems;
+    };
+
+} // namespace SCPY
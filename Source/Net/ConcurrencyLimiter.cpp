@@ -0,0 +1,111 @@
+#include "ConcurrencyLimiter.h"
+
+// std
+#include <algorithm>
+
+
+
+namespace SCPY
+{
+    namespace
+    {
+        constexpr double s_LatencySmoothing = 0.2;
+        constexpr double s_StableLatencyRatio = 2.0;
+        constexpr double s_DecreaseFactor = 0.5;
+
+    } // namespace
+
+    ConcurrencyLimiter::ConcurrencyLimiter(uint32_t p_Min, uint32_t p_Max, uint32_t p_Initial)
+    {
+        SetBounds(p_Min, p_Max);
+        m_Limit = std::clamp<double>(p_Initial, m_Min, m_Max);
+    }
+
+    bool ConcurrencyLimiter::Acquire(const std::function<bool()>& p_IsCancelled)
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        while (m_InFlight >= uint32_t(m_Limit))
+        {
+            if (p_IsCancelled && p_IsCancelled())
+                return false;
+
+            m_Condition.wait_for(lock, std::chrono::milliseconds(50));
+        }
+
+        m_InFlight++;
+        return true;
+    }
+
+    void ConcurrencyLimiter::Release(RequestOutcome p_Outcome, std::chrono::milliseconds p_Latency)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_InFlight--;
+
+            auto now = std::chrono::steady_clock::now();
+            double latency = (double)p_Latency.count();
+
+            if (p_Outcome == RequestOutcome::Success)
+            {
+                m_Latency = m_Latency == 0.0 ? latency : m_Latency + s_LatencySmoothing * (latency - m_Latency);
+
+                // the baseline slowly forgets old minimums so a route change does not pin it forever
+                m_BaseLatency = m_BaseLatency == 0.0 ? latency : std::min(latency, m_BaseLatency * 1.01);
+
+                if (m_Latency <= m_BaseLatency * s_StableLatencyRatio)
+                    m_Limit = std::min<double>(m_Max, m_Limit + 1.0 / m_Limit);
+            }
+            else if (p_Outcome == RequestOutcome::Overload)
+            {
+                // every request already in flight saw the same overload, back off once per round trip
+                auto window = std::chrono::milliseconds((int64_t)std::max(m_Latency, 1000.0));
+                if (now - m_LastDecrease >= window)
+                {
+                    m_Limit = std::max<double>(m_Min, m_Limit * s_DecreaseFactor);
+                    m_LastDecrease = now;
+                }
+            }
+        }
+
+        m_Condition.notify_all();
+    }
+
+    void ConcurrencyLimiter::SetBounds(uint32_t p_Min, uint32_t p_Max)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Min = std::max(1u, p_Min);
+        m_Max = std::max(m_Min, p_Max);
+        m_Limit = std::clamp<double>(m_Limit, m_Min, m_Max);
+    }
+
+    uint32_t ConcurrencyLimiter::GetLimit()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return uint32_t(m_Limit);
+    }
+
+    uint32_t ConcurrencyLimiter::GetMin()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Min;
+    }
+
+    uint32_t ConcurrencyLimiter::GetMax()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Max;
+    }
+
+    uint32_t ConcurrencyLimiter::GetInFlight()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_InFlight;
+    }
+
+    std::chrono::milliseconds ConcurrencyLimiter::GetLatency()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return std::chrono::milliseconds((int64_t)m_Latency);
+    }
+
+} // namespace SCPY
@@ -0,0 +1,77 @@
+#pragma once
+
+// std
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+
+
+namespace SCPY
+{
+    enum class RequestOutcome : uint8_t
+    {
+        Success = 0,
+        Overload,   // non 200 status, timeout or connection error
+        Ignored     // cancelled by us, says nothing about the server
+    };
+
+    // AIMD limit on requests in flight: +1 per window of successes while latency stays near
+    // its baseline, halved on overload. Starts low and finds the sustainable level by itself.
+    class ConcurrencyLimiter
+    {
+        public:
+            ConcurrencyLimiter(uint32_t p_Min = 1, uint32_t p_Max = 16, uint32_t p_Initial = 2);
+
+            // Blocks until a slot is free, returns false if p_IsCancelled fired while waiting
+            bool Acquire(const std::function<bool()>& p_IsCancelled = nullptr);
+            void Release(RequestOutcome p_Outcome, std::chrono::milliseconds p_Latency);
+
+            void SetBounds(uint32_t p_Min, uint32_t p_Max);
+
+            uint32_t GetLimit();
+            uint32_t GetMin();
+            uint32_t GetMax();
+            uint32_t GetInFlight();
+            std::chrono::milliseconds GetLatency();
+
+        private:
+            double m_Limit = 2.0;
+            uint32_t m_Min = 1;
+            uint32_t m_Max = 16;
+            uint32_t m_InFlight = 0;
+
+            // smoothed latency against the best seen, in milliseconds
+            double m_Latency = 0.0;
+            double m_BaseLatency = 0.0;
+            std::chrono::steady_clock::time_point m_LastDecrease;
+
+            std::mutex m_Mutex;
+            std::condition_variable m_Condition;
+    };
+
+    // A slot taken with Acquire. Given back as Ignored if nothing released it, so an exception
+    // between Acquire and Release cannot shrink the limiter for good.
+    class ConcurrencySlot
+    {
+        public:
+            explicit ConcurrencySlot(ConcurrencyLimiter& p_Limiter) : m_Limiter(&p_Limiter) {}
+            ~ConcurrencySlot() { Release(RequestOutcome::Ignored, std::chrono::milliseconds(0)); }
+
+            ConcurrencySlot(const ConcurrencySlot&) = delete;
+            ConcurrencySlot& operator=(const ConcurrencySlot&) = delete;
+
+            void Release(RequestOutcome p_Outcome, std::chrono::milliseconds p_Latency)
+            {
+                if (m_Limiter)
+                    std::exchange(m_Limiter, nullptr)->Release(p_Outcome, p_Latency);
+            }
+
+        private:
+            ConcurrencyLimiter* m_Limiter;
+    };
+
+} // namespace SCPY
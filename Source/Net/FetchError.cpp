@@ -0,0 +1,69 @@
+#include "FetchError.h"
+#include "Core/Base.h"
+
+
+
+namespace SCPY
+{
+    FetchError::FetchError(FetchErrorKind p_Kind, const std::string& p_Url, long p_StatusCode, const std::string& p_Message)
+        : std::runtime_error(p_Message), m_Kind(p_Kind), m_Url(p_Url), m_StatusCode(p_StatusCode)
+    {
+    }
+
+    FetchError FetchError::FromResponse(const std::string& p_Url, const cpr::Response& p_Response)
+    {
+        if (p_Response.error)
+        {
+            FetchErrorKind kind = FetchErrorKind::Transport;
+            switch (p_Response.error.code)
+            {
+                case cpr::ErrorCode::OPERATION_TIMEDOUT:
+                    kind = FetchErrorKind::Timeout;
+                    break;
+                case cpr::ErrorCode::COULDNT_CONNECT:
+                case cpr::ErrorCode::COULDNT_RESOLVE_HOST:
+                case cpr::ErrorCode::COULDNT_RESOLVE_PROXY:
+                case cpr::ErrorCode::GOT_NOTHING:
+                case cpr::ErrorCode::SEND_ERROR:
+                case cpr::ErrorCode::RECV_ERROR:
+                case cpr::ErrorCode::PARTIAL_FILE:
+                    kind = FetchErrorKind::Network;
+                    break;
+                default:
+                    break;
+            }
+
+            return FetchError(kind, p_Url, 0, std::format("Failed to access the site: {}", p_Response.error.message));
+        }
+
+        FetchError error(FetchErrorKind::HttpStatus, p_Url, p_Response.status_code, 
+            std::format("Failed to access the site: {}", p_Response.status_code));
+
+        auto retryAfter = p_Response.header.find("Retry-After");
+        if (retryAfter != p_Response.header.end())
+        {
+            // the HTTP-date form is rare enough to fall back to the policy's own delay
+            char* end = nullptr;
+            long seconds = std::strtol(retryAfter->second.c_str(), &end, 10);
+            if (end != retryAfter->second.c_str() && seconds > 0)
+                error.m_RetryAfter = std::chrono::seconds(seconds);
+        }
+
+        return error;
+    }
+
+    bool FetchError::IsRetryable() const
+    {
+        switch (m_Kind)
+        {
+            case FetchErrorKind::Timeout:
+            case FetchErrorKind::Network:
+                return true;
+            case FetchErrorKind::HttpStatus:
+                return m_StatusCode == 408 || m_StatusCode == 429 || m_StatusCode >= 500;
+            default:
+                return false;
+        }
+    }
+
+} // namespace SCPY
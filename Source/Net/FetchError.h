@@ -0,0 +1,50 @@
+#pragma once
+
+// lib
+#include <cpr/cpr.h>
+
+// std
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+
+
+namespace SCPY
+{
+    enum class FetchErrorKind : uint8_t
+    {
+        Timeout = 0,
+        Network,    // connection, DNS or a transfer cut short
+        Transport,  // SSL, malformed URL, unsupported protocol and the like, retrying gives the same answer
+        HttpStatus,
+        Parse
+    };
+
+    class FetchError : public std::runtime_error
+    {
+        public:
+            FetchError(FetchErrorKind p_Kind, const std::string& p_Url, long p_StatusCode, const std::string& p_Message);
+
+            static FetchError FromResponse(const std::string& p_Url, const cpr::Response& p_Response);
+
+            // Timeouts, connection failures, 408, 429 and 5xx may go away on their own, anything else will not.
+            // A page that downloaded but does not parse is not retried either, SCON would send the same one.
+            bool IsRetryable() const;
+
+            FetchErrorKind GetKind() const { return m_Kind; }
+            const std::string& GetUrl() const { return m_Url; }
+            long GetStatusCode() const { return m_StatusCode; }
+
+            // Parsed from a Retry-After header given in seconds, zero when absent. Uncapped, callers clamp it to their own limit.
+            std::chrono::seconds GetRetryAfter() const { return m_RetryAfter; }
+
+        private:
+            FetchErrorKind m_Kind;
+            std::string m_Url;
+            long m_StatusCode = 0;
+            std::chrono::seconds m_RetryAfter{ 0 };
+    };
+
+} // namespace SCPY
@@ -0,0 +1,288 @@
+#include "HttpCache.h"
+#include "Core/Base.h"
+
+// lib
+#include <yaml-cpp/yaml.h>
+
+// std
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+
+
+namespace SCPY
+{
+    namespace
+    {
+        constexpr const char* s_Magic = "SCPY-HTTP-CACHE";
+        constexpr int s_Version = 2;
+
+        // the body is streamed first, so the meta size goes in a fixed width trailer
+        constexpr size_t s_TrailerSize = 17;
+
+        uint64_t HashFNV1a(const std::string& p_Text)
+        {
+            uint64_t hash = 0xcbf29ce484222325ull;
+            for (unsigned char c : p_Text)
+            {
+                hash ^= c;
+                hash *= 0x100000001b3ull;
+            }
+            return hash;
+        }
+
+        int64_t Now()
+        {
+            return std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+
+        std::string GetHeader(const cpr::Header& p_Header, const char* p_Name)
+        {
+            auto it = p_Header.find(p_Name);
+            return it != p_Header.end() ? it->second : "";
+        }
+
+    } // namespace
+
+    HttpCache::Writer::Writer(const std::filesystem::path& p_Path, std::string p_NormalizedUrl)
+        : m_Path(p_Path), m_Url(std::move(p_NormalizedUrl))
+    {
+        // several workers may store the same url, each writes its own temporary and the rename wins atomically
+        m_Temporary = m_Path;
+        m_Temporary += std::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+        m_File.open(m_Temporary, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!m_File)
+            LOG("ERROR: Failed to write http cache entry {}", m_Temporary.string());
+
+        m_File << s_Magic << ' ' << s_Version << '\n';
+    }
+
+    HttpCache::Writer::~Writer()
+    {
+        if (m_Committed)
+            return;
+
+        m_File.close();
+
+        std::error_code error;
+        std::filesystem::remove(m_Temporary, error);
+    }
+
+    void HttpCache::Writer::Append(std::string_view p_Chunk)
+    {
+        m_File.write(p_Chunk.data(), p_Chunk.size());
+    }
+
+    bool HttpCache::Writer::Commit(long p_StatusCode, const cpr::Header& p_Header)
+    {
+        if (!m_File || GetHeader(p_Header, "Cache-Control").find("no-store") != std::string::npos)
+            return false;
+
+        YAML::Emitter meta;
+        meta << YAML::BeginMap;
+        meta << YAML::Key << "Url" << YAML::Value << m_Url;
+        meta << YAML::Key << "Status" << YAML::Value << p_StatusCode;
+        meta << YAML::Key << "StoredAt" << YAML::Value << Now();
+        meta << YAML::Key << "Header" << YAML::Value << YAML::BeginMap;
+        for (const auto& [name, value] : p_Header)
+            meta << YAML::Key << name << YAML::Value << value;
+        meta << YAML::EndMap;
+        meta << YAML::EndMap;
+
+        m_File.write(meta.c_str(), meta.size());
+        m_File << std::format("{:016}\n", meta.size());
+        m_File.close();
+
+        if (!m_File)
+        {
+            LOG("ERROR: Failed to write http cache entry {}", m_Temporary.string());
+            return false;
+        }
+
+        std::error_code error;
+        std::filesystem::rename(m_Temporary, m_Path, error);
+        if (error)
+        {
+            LOG("ERROR: Failed to commit http cache entry {}: {}", m_Path.string(), error.message());
+            return false;
+        }
+
+        m_Committed = true;
+        return true;
+    }
+
+    HttpCache::HttpCache(const std::filesystem::path& p_Directory, std::chrono::seconds p_TTL)
+        : m_Directory(p_Directory), m_TTL(p_TTL)
+    {
+        std::error_code error;
+        std::filesystem::create_directories(m_Directory, error);
+        if (error)
+            LOG("ERROR: Failed to create the http cache directory {}: {}", m_Directory.string(), error.message());
+    }
+
+    std::optional<CachedResponse> HttpCache::Load(const std::string& p_Url) const
+    {
+        std::string url = NormalizeUrl(p_Url);
+
+        std::ifstream file(GetEntryPath(url), std::ios::in | std::ios::binary);
+        if (!file)
+            return std::nullopt;
+
+        std::string magic;
+        int version = 0;
+        file >> magic >> version;
+        file.get(); // '\n'
+
+        if (!file || magic != s_Magic || version != s_Version)
+            return std::nullopt;
+
+        std::streamoff bodyStart = file.tellg();
+
+        char trailer[s_TrailerSize] = {};
+        file.seekg(-(std::streamoff)s_TrailerSize, std::ios::end);
+        std::streamoff trailerStart = file.tellg();
+        file.read(trailer, s_TrailerSize);
+        if (!file || trailer[s_TrailerSize - 1] != '\n')
+            return std::nullopt;
+
+        std::streamoff metaSize = std::strtoll(trailer, nullptr, 10);
+        std::streamoff bodySize = trailerStart - metaSize - bodyStart;
+        if (metaSize <= 0 || bodySize < 0)
+            return std::nullopt;
+
+        CachedResponse entry;
+        entry.Body.resize((size_t)bodySize);
+        std::string meta((size_t)metaSize, '\0');
+
+        file.seekg(bodyStart);
+        file.read(entry.Body.data(), bodySize);
+        file.read(meta.data(), metaSize);
+        if (!file)
+            return std::nullopt;
+
+        try
+        {
+            YAML::Node node = YAML::Load(meta);
+
+            // a different url that hashed to the same file
+            if (node["Url"].as<std::string>() != url)
+                return std::nullopt;
+
+            entry.Url = url;
+            entry.StatusCode = node["Status"].as<long>();
+            entry.StoredAt = node["StoredAt"].as<int64_t>();
+
+            for (const auto& header : node["Header"])
+                entry.Header[header.first.as<std::string>()] = header.second.as<std::string>();
+        }
+        catch (const YAML::Exception& e)
+        {
+            LOG("ERROR: Corrupted http cache entry for {}: {}", url, e.what());
+            return std::nullopt;
+        }
+
+        return entry;
+    }
+
+    std::unique_ptr<HttpCache::Writer> HttpCache::BeginStore(const std::string& p_Url) const
+    {
+        std::string url = NormalizeUrl(p_Url);
+        return std::make_unique<Writer>(GetEntryPath(url), url);
+    }
+
+    void HttpCache::Revalidate(const std::string& p_Url, CachedResponse& p_Entry, const cpr::Header& p_Header) const
+    {
+        for (const char* name : { "ETag", "Last-Modified", "Cache-Control", "Expires", "Date" })
+        {
+            std::string value = GetHeader(p_Header, name);
+            if (!value.empty())
+                p_Entry.Header[name] = value;
+        }
+        p_Entry.StoredAt = Now();
+
+        auto writer = BeginStore(p_Url);
+        writer->Append(p_Entry.Body);
+        writer->Commit(p_Entry.StatusCode, p_Entry.Header);
+    }
+
+    bool HttpCache::IsFresh(const CachedResponse& p_Entry) const
+    {
+        return Now() - p_Entry.StoredAt < m_TTL.count();
+    }
+
+    void HttpCache::Remove(const std::string& p_Url) const
+    {
+        std::error_code error;
+        std::filesystem::remove(GetEntryPath(NormalizeUrl(p_Url)), error);
+    }
+
+    void HttpCache::Clear() const
+    {
+        std::error_code error;
+        for (const auto& file : std::filesystem::directory_iterator(m_Directory, error))
+        {
+            if (file.path().extension() == ".entry")
+                std::filesystem::remove(file.path(), error);
+        }
+    }
+
+    void HttpCache::AddConditionalHeaders(const CachedResponse& p_Entry, cpr::Header& p_Header)
+    {
+        std::string etag = GetHeader(p_Entry.Header, "ETag");
+        if (!etag.empty())
+            p_Header["If-None-Match"] = etag;
+
+        std::string lastModified = GetHeader(p_Entry.Header, "Last-Modified");
+        if (!lastModified.empty())
+            p_Header["If-Modified-Since"] = lastModified;
+    }
+
+    std::string HttpCache::NormalizeUrl(const std::string& p_Url)
+    {
+        std::string url = p_Url.substr(0, p_Url.find('#'));
+
+        size_t queryStart = url.find('?');
+        std::string base = url.substr(0, queryStart);
+        std::string query = queryStart != std::string::npos ? url.substr(queryStart + 1) : "";
+
+        // scheme and host are case insensitive, the path is not
+        size_t hostStart = base.find("://");
+        size_t pathStart = base.find('/', hostStart == std::string::npos ? 0 : hostStart + 3);
+        std::transform(base.begin(), pathStart == std::string::npos ? base.end() : base.begin() + pathStart, base.begin(), 
+            [](unsigned char c) { return (char)std::tolower(c); });
+
+        if (query.empty())
+            return base;
+
+        std::vector<std::string> params;
+        std::stringstream stream(query);
+        std::string param;
+        while (std::getline(stream, param, '&'))
+        {
+            if (!param.empty())
+                params.push_back(param);
+        }
+        std::sort(params.begin(), params.end());
+
+        std::string normalized = base + "?";
+        for (size_t i = 0; i < params.size(); i++)
+        {
+            if (i > 0) normalized += '&';
+            normalized += params[i];
+        }
+
+        return normalized;
+    }
+
+    std::filesystem::path HttpCache::GetEntryPath(const std::string& p_NormalizedUrl) const
+    {
+        return m_Directory / std::format("{:016x}.entry", HashFNV1a(p_NormalizedUrl));
+    }
+
+} // namespace SCPY
@@ -0,0 +1,86 @@
+#pragma once
+
+// lib
+#include <cpr/cpr.h>
+
+// std
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+
+
+namespace SCPY
+{
+    struct CachedResponse
+    {
+        std::string Url;
+        long StatusCode = 0;
+        cpr::Header Header;
+        std::string Body;
+        int64_t StoredAt = 0; // unix seconds
+    };
+
+    // Disk cache of raw responses, one file per normalized url named after its hash.
+    // Stale entries are not dropped, they carry the validators for a conditional GET.
+    class HttpCache
+    {
+        public:
+            // Streams a body to a temporary file as it downloads, the entry only appears on Commit.
+            class Writer
+            {
+                public:
+                    Writer(const std::filesystem::path& p_Path, std::string p_NormalizedUrl);
+                    ~Writer();
+
+                    Writer(const Writer&) = delete;
+                    Writer& operator=(const Writer&) = delete;
+
+                    void Append(std::string_view p_Chunk);
+
+                    // Cache-Control: no-store discards the entry instead
+                    bool Commit(long p_StatusCode, const cpr::Header& p_Header);
+
+                private:
+                    std::filesystem::path m_Path;
+                    std::filesystem::path m_Temporary;
+                    std::string m_Url;
+                    std::ofstream m_File;
+                    bool m_Committed = false;
+            };
+
+        public:
+            HttpCache(const std::filesystem::path& p_Directory, std::chrono::seconds p_TTL);
+
+            std::optional<CachedResponse> Load(const std::string& p_Url) const;
+            std::unique_ptr<Writer> BeginStore(const std::string& p_Url) const;
+
+            // A 304 confirmed the entry, restart its TTL and merge the new validators
+            void Revalidate(const std::string& p_Url, CachedResponse& p_Entry, const cpr::Header& p_Header) const;
+
+            bool IsFresh(const CachedResponse& p_Entry) const;
+            void Remove(const std::string& p_Url) const;
+            void Clear() const;
+
+            void SetTTL(std::chrono::seconds p_TTL) { m_TTL = p_TTL; }
+            std::chrono::seconds GetTTL() const { return m_TTL; }
+            const std::filesystem::path& GetDirectory() const { return m_Directory; }
+
+            // Adds If-None-Match / If-Modified-Since from the entry's validators
+            static void AddConditionalHeaders(const CachedResponse& p_Entry, cpr::Header& p_Header);
+            static std::string NormalizeUrl(const std::string& p_Url);
+
+        private:
+            std::filesystem::path GetEntryPath(const std::string& p_NormalizedUrl) const;
+
+        private:
+            std::filesystem::path m_Directory;
+            std::chrono::seconds m_TTL;
+    };
+
+} // namespace SCPY
@@ -0,0 +1,74 @@
+#include "RateLimiter.h"
+
+// std
+#include <algorithm>
+#include <thread>
+
+
+
+namespace SCPY
+{
+    RateLimiter::RateLimiter(double p_RequestsPerSecond, double p_Burst)
+    {
+        SetRate(p_RequestsPerSecond, p_Burst);
+    }
+
+    bool RateLimiter::Acquire(const std::function<bool()>& p_IsCancelled)
+    {
+        while (true)
+        {
+            std::chrono::duration<double> wait;
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                if (m_Rate <= 0.0)
+                    return true;
+
+                RefillLocked(std::chrono::steady_clock::now());
+                if (m_Tokens >= 1.0)
+                {
+                    m_Tokens -= 1.0;
+                    return true;
+                }
+
+                wait = std::chrono::duration<double>((1.0 - m_Tokens) / m_Rate);
+            }
+
+            if (p_IsCancelled && p_IsCancelled())
+                return false;
+
+            // short naps so a cancelled request does not sit out a long refill
+            auto nap = std::min<std::chrono::steady_clock::duration>(
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(wait), std::chrono::milliseconds(50));
+            std::this_thread::sleep_for(nap);
+        }
+    }
+
+    void RateLimiter::SetRate(double p_RequestsPerSecond, double p_Burst)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Rate = p_RequestsPerSecond;
+        m_Burst = std::max(1.0, p_Burst);
+        m_Tokens = m_Burst;
+        m_LastRefill = std::chrono::steady_clock::now();
+    }
+
+    double RateLimiter::GetRate()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Rate;
+    }
+
+    double RateLimiter::GetBurst()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Burst;
+    }
+
+    void RateLimiter::RefillLocked(std::chrono::steady_clock::time_point p_Now)
+    {
+        std::chrono::duration<double> elapsed = p_Now - m_LastRefill;
+        m_Tokens = std::min(m_Burst, m_Tokens + elapsed.count() * m_Rate);
+        m_LastRefill = p_Now;
+    }
+
+} // namespace SCPY
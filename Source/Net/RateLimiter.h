@@ -0,0 +1,38 @@
+#pragma once
+
+// std
+#include <chrono>
+#include <functional>
+#include <mutex>
+
+
+
+namespace SCPY
+{
+    // Token bucket: refills at p_RequestsPerSecond and holds at most p_Burst tokens.
+    // A rate of zero or less disables the limit.
+    class RateLimiter
+    {
+        public:
+            RateLimiter(double p_RequestsPerSecond, double p_Burst);
+
+            // Blocks until a token is available, returns false if p_IsCancelled fired while waiting
+            bool Acquire(const std::function<bool()>& p_IsCancelled = nullptr);
+
+            void SetRate(double p_RequestsPerSecond, double p_Burst);
+            double GetRate();
+            double GetBurst();
+
+        private:
+            void RefillLocked(std::chrono::steady_clock::time_point p_Now);
+
+        private:
+            double m_Rate = 0.0;
+            double m_Burst = 1.0;
+            double m_Tokens = 0.0;
+            std::chrono::steady_clock::time_point m_LastRefill;
+
+            std::mutex m_Mutex;
+    };
+
+} // namespace SCPY
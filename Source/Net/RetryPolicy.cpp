@@ -0,0 +1,41 @@
+#include "RetryPolicy.h"
+
+// std
+#include <algorithm>
+#include <random>
+
+
+
+namespace SCPY
+{
+    std::chrono::milliseconds RetryPolicy::GetDelay(uint32_t p_Attempt) const
+    {
+        thread_local std::mt19937_64 s_Random{ std::random_device{}() };
+
+        int64_t ceiling = BaseDelay.count() << std::min<uint32_t>(p_Attempt, 20);
+        ceiling = std::min<int64_t>(ceiling, MaxDelay.count());
+
+        std::uniform_int_distribution<int64_t> distribution(0, std::max<int64_t>(ceiling, 0));
+        return std::chrono::milliseconds(distribution(s_Random));
+    }
+
+    RetryBudget::RetryBudget(double p_Ratio, uint32_t p_Minimum)
+        : m_Ratio(p_Ratio), m_Minimum(p_Minimum)
+    {
+    }
+
+    bool RetryBudget::TryConsume()
+    {
+        uint32_t retries = m_Retries.load();
+        do
+        {
+            uint32_t allowed = m_Minimum + uint32_t(m_Requests.load() * m_Ratio);
+            if (retries >= allowed)
+                return false;
+        } 
+        while (!m_Retries.compare_exchange_weak(retries, retries + 1));
+
+        return true;
+    }
+
+} // namespace SCPY
@@ -0,0 +1,46 @@
+#pragma once
+
+// std
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+
+
+namespace SCPY
+{
+    struct RetryPolicy
+    {
+        uint32_t MaxAttempts = 5;
+        std::chrono::milliseconds BaseDelay{ 500 };
+        std::chrono::milliseconds MaxDelay{ 30000 };
+
+        // per attempt
+        std::chrono::milliseconds ConnectTimeout{ 10000 };
+        std::chrono::milliseconds Timeout{ 60000 };
+
+        // Full jitter: uniform in [0, min(MaxDelay, BaseDelay * 2^attempt)]
+        std::chrono::milliseconds GetDelay(uint32_t p_Attempt) const;
+    };
+
+    // Caps the retries of a whole crawl to a share of its requests, so a server that is down
+    // fails the crawl fast instead of multiplying the load by MaxAttempts.
+    class RetryBudget
+    {
+        public:
+            RetryBudget(double p_Ratio = 0.2, uint32_t p_Minimum = 20);
+
+            void OnRequest() { m_Requests++; }
+            bool TryConsume();
+
+            uint32_t GetRetries() const { return m_Retries; }
+
+        private:
+            const double m_Ratio;
+            const uint32_t m_Minimum;
+
+            std::atomic<uint32_t> m_Requests = 0;
+            std::atomic<uint32_t> m_Retries = 0;
+    };
+
+} // namespace SCPY
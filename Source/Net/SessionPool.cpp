@@ -0,0 +1,139 @@
+#include "SessionPool.h"
+
+// std
+#include <algorithm>
+#include <string_view>
+
+
+
+namespace SCPY
+{
+    SessionPool::SessionPool(cpr::Header p_DefaultHeader, uint32_t p_MaxIdle)
+        : m_DefaultHeader(std::move(p_DefaultHeader)), m_MaxIdle(p_MaxIdle)
+    {
+    }
+
+    cpr::Response SessionPool::Get(const std::string& p_Url, const cpr::Header& p_Header, const cpr::ProgressCallback& p_Progress, 
+        const cpr::WriteCallback& p_Write, const HeadersFn& p_OnHeaders)
+    {
+        auto pooled = Acquire();
+        cpr::Session& session = pooled->Session;
+
+        session.SetUrl(cpr::Url{p_Url});
+        session.SetConnectTimeout(cpr::ConnectTimeout{std::chrono::milliseconds(m_ConnectTimeout.load())});
+        session.SetTimeout(cpr::Timeout{std::chrono::milliseconds(m_Timeout.load())});
+
+        // the session keeps the callback of its previous request, an empty one would throw inside curl
+        if (p_Progress.callback)
+            session.SetProgressCallback(p_Progress);
+        else
+            session.SetProgressCallback(cpr::ProgressCallback([](auto, auto, auto, auto, intptr_t) { return true; }));
+
+        // an empty write callback puts back cpr's own, which buffers into the response text
+        session.SetWriteCallback(p_Write);
+
+        // a header callback takes over cpr's header parsing, so the lines are collected here instead
+        cpr::Header received;
+        if (p_OnHeaders)
+        {
+            long status = 0;
+            session.SetHeaderCallback(cpr::HeaderCallback([&received, &status, &p_OnHeaders](auto p_Line, intptr_t)
+            {
+                std::string_view line(p_Line);
+                while (!line.empty() && (line.back() == '\n' || line.back() == '\r'))
+                    line.remove_suffix(1);
+
+                // a status line starts a new block, after a redirect or a 100 Continue
+                if (line.starts_with("HTTP/"))
+                {
+                    received.clear();
+                    status = 0;
+
+                    size_t space = line.find(' ');
+                    for (size_t i = space == std::string_view::npos ? line.size() : space + 1; i < line.size() && line[i] >= '0' && line[i] <= '9'; i++)
+                        status = status * 10 + (line[i] - '0');
+                }
+                // only the final response describes the body, a redirect's charset must not decide how it is decoded
+                else if (line.empty())
+                {
+                    if (status >= 200 && status < 300)
+                        p_OnHeaders(received);
+                }
+                else
+                {
+                    size_t colon = line.find(':');
+                    if (colon != std::string_view::npos)
+                    {
+                        std::string_view value = line.substr(colon + 1);
+                        value.remove_prefix(std::min(value.find_first_not_of(" \t"), value.size()));
+                        received[std::string(line.substr(0, colon))] = std::string(value);
+                    }
+                }
+
+                return true;
+            }));
+        }
+        else
+            session.SetHeaderCallback(cpr::HeaderCallback{});
+
+        // only rebuild the header when this request or the previous one changed it
+        if (!p_Header.empty())
+        {
+            cpr::Header header = m_DefaultHeader;
+            for (const auto& [name, value] : p_Header)
+                header[name] = value;
+
+            session.SetHeader(header);
+            pooled->HasCustomHeader = true;
+        }
+        else if (pooled->HasCustomHeader)
+        {
+            session.SetHeader(m_DefaultHeader);
+            pooled->HasCustomHeader = false;
+        }
+
+        cpr::Response response = session.Get();
+        if (p_OnHeaders)
+            response.header = std::move(received);
+
+        Release(std::move(pooled));
+        return response;
+    }
+
+    void SessionPool::SetTimeouts(std::chrono::milliseconds p_Connect, std::chrono::milliseconds p_Total)
+    {
+        m_ConnectTimeout = p_Connect.count();
+        m_Timeout = p_Total.count();
+    }
+
+    size_t SessionPool::GetIdleCount()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Idle.size();
+    }
+
+    std::unique_ptr<SessionPool::PooledSession> SessionPool::Acquire()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (!m_Idle.empty())
+            {
+                auto pooled = std::move(m_Idle.back());
+                m_Idle.pop_back();
+                return pooled;
+            }
+        }
+
+        auto pooled = std::make_unique<PooledSession>();
+        pooled->Session.SetHeader(m_DefaultHeader);
+        return pooled;
+    }
+
+    void SessionPool::Release(std::unique_ptr<PooledSession> p_Session)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_Idle.size() < m_MaxIdle)
+            m_Idle.push_back(std::move(p_Session));
+    }
+
+} // namespace SCPY
@@ -0,0 +1,65 @@
+#pragma once
+
+// lib
+#include <cpr/cpr.h>
+
+// std
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+
+namespace SCPY
+{
+    // Keeps cpr sessions (and so their curl handles and open connections) alive between requests.
+    // Each request borrows a session, so any number of threads can fetch at once.
+    class SessionPool
+    {
+        public:
+            using HeadersFn = std::function<void(const cpr::Header&)>;
+
+            explicit SessionPool(cpr::Header p_DefaultHeader, uint32_t p_MaxIdle = 16);
+
+            SessionPool(const SessionPool&) = delete;
+            SessionPool& operator=(const SessionPool&) = delete;
+
+            // p_Header is merged over the default header for this request only.
+            // With p_Write the body goes to the callback as it arrives and the response text stays empty,
+            // p_OnHeaders then gets the header of the 2xx response before the first chunk, never the one of a redirect or a 1xx.
+            cpr::Response Get(const std::string& p_Url, const cpr::Header& p_Header = {}, const cpr::ProgressCallback& p_Progress = {}, 
+                const cpr::WriteCallback& p_Write = {}, const HeadersFn& p_OnHeaders = {});
+
+            // applied to every request from now on, zero means no limit
+            void SetTimeouts(std::chrono::milliseconds p_Connect, std::chrono::milliseconds p_Total);
+
+            const cpr::Header& GetDefaultHeader() const { return m_DefaultHeader; }
+            size_t GetIdleCount();
+
+        private:
+            struct PooledSession
+            {
+                cpr::Session Session;
+                bool HasCustomHeader = false;
+            };
+
+            std::unique_ptr<PooledSession> Acquire();
+            void Release(std::unique_ptr<PooledSession> p_Session);
+
+        private:
+            const cpr::Header m_DefaultHeader;
+            const uint32_t m_MaxIdle;
+
+            std::atomic<int64_t> m_ConnectTimeout = 0;
+            std::atomic<int64_t> m_Timeout = 0;
+
+            std::vector<std::unique_ptr<PooledSession>> m_Idle;
+            std::mutex m_Mutex;
+    };
+
+} // namespace SCPY
@@ -0,0 +1,617 @@
+#include "Encoding.h"
+#include "Core/Base.h"
+#include "Core/Simd.h"
+
+#ifndef _WIN32
+    #include <iconv.h>
+    #include <cerrno>
+#endif
+
+// std
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstring>
+#include <unordered_map>
+
+
+
+namespace SCPY
+{
+    namespace
+    {
+        // 0 for bytes that cannot start a sequence
+        inline size_t GetSequenceLength(unsigned char p_Lead)
+        {
+            if (p_Lead < 0x80) return 1;
+            if (p_Lead >= 0xC2 && p_Lead <= 0xDF) return 2;
+            if (p_Lead >= 0xE0 && p_Lead <= 0xEF) return 3;
+            if (p_Lead >= 0xF0 && p_Lead <= 0xF4) return 4;
+            return 0;
+        }
+
+        inline bool IsAscii8(const char* p_Data)
+        {
+            uint64_t word;
+            std::memcpy(&word, p_Data, sizeof(word));
+            return (word & 0x8080808080808080ull) == 0;
+        }
+
+    #ifdef SCPY_X86
+        // Lookup based validation (Keiser & Lemire, "Validating UTF-8 in less than one instruction per byte").
+        // Each byte is classified by the high nibble of the previous byte, its low nibble and the high nibble
+        // of the current byte, every error class sets a bit and a valid pair ANDs to zero.
+        constexpr uint8_t TOO_SHORT      = 1 << 0;
+        constexpr uint8_t TOO_LONG       = 1 << 1;
+        constexpr uint8_t OVERLONG_3     = 1 << 2;
+        constexpr uint8_t TOO_LARGE      = 1 << 3;
+        constexpr uint8_t SURROGATE      = 1 << 4;
+        constexpr uint8_t OVERLONG_2     = 1 << 5;
+        constexpr uint8_t TOO_LARGE_1000 = 1 << 6;
+        constexpr uint8_t OVERLONG_4     = 1 << 6;
+        constexpr uint8_t TWO_CONTS      = 1 << 7;
+        constexpr uint8_t CARRY          = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+        constexpr uint8_t s_Byte1High[16] = {
+            TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+            TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+            TOO_SHORT | OVERLONG_2,
+            TOO_SHORT,
+            TOO_SHORT | OVERLONG_3 | SURROGATE,
+            TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+        };
+
+        constexpr uint8_t s_Byte1Low[16] = {
+            CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+            CARRY | OVERLONG_2,
+            CARRY,
+            CARRY,
+            CARRY | TOO_LARGE,
+            CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000
+        };
+
+        constexpr uint8_t s_Byte2High[16] = {
+            TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+            TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+        };
+
+        struct StateSSSE3
+        {
+            __m128i Error;
+            __m128i PrevInput;
+            __m128i PrevIncomplete;
+        };
+
+        SCPY_TARGET("ssse3")
+        void CheckSSSE3(StateSSSE3& p_State, __m128i p_Input)
+        {
+            if (_mm_movemask_epi8(p_Input) == 0)
+            {
+                // an ascii block cannot finish what the previous one left open
+                p_State.Error = _mm_or_si128(p_State.Error, p_State.PrevIncomplete);
+                p_State.PrevIncomplete = _mm_setzero_si128();
+                p_State.PrevInput = p_Input;
+                return;
+            }
+
+            const __m128i nibble = _mm_set1_epi8(0x0F);
+            const __m128i byte1High = _mm_loadu_si128((const __m128i*)s_Byte1High);
+            const __m128i byte1Low = _mm_loadu_si128((const __m128i*)s_Byte1Low);
+            const __m128i byte2High = _mm_loadu_si128((const __m128i*)s_Byte2High);
+
+            __m128i prev1 = _mm_alignr_epi8(p_Input, p_State.PrevInput, 15);
+            __m128i prev2 = _mm_alignr_epi8(p_Input, p_State.PrevInput, 14);
+            __m128i prev3 = _mm_alignr_epi8(p_Input, p_State.PrevInput, 13);
+
+            __m128i special = _mm_and_si128(
+                _mm_and_si128(
+                    _mm_shuffle_epi8(byte1High, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+                    _mm_shuffle_epi8(byte1Low, _mm_and_si128(prev1, nibble))),
+                _mm_shuffle_epi8(byte2High, _mm_and_si128(_mm_srli_epi16(p_Input, 4), nibble)));
+
+            // the third and fourth bytes of long sequences must be continuations
+            __m128i thirdByte = _mm_subs_epu8(prev2, _mm_set1_epi8((char)(0xE0 - 0x80)));
+            __m128i fourthByte = _mm_subs_epu8(prev3, _mm_set1_epi8((char)(0xF0 - 0x80)));
+            __m128i mustBeContinuation = _mm_and_si128(_mm_or_si128(thirdByte, fourthByte), _mm_set1_epi8((char)0x80));
+
+            p_State.Error = _mm_or_si128(p_State.Error, _mm_xor_si128(mustBeContinuation, special));
+
+            const __m128i maxValue = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, (char)0xEF, (char)0xDF, (char)0xBF);
+            p_State.PrevIncomplete = _mm_subs_epu8(p_Input, maxValue);
+            p_State.PrevInput = p_Input;
+        }
+
+        SCPY_TARGET("ssse3")
+        bool ValidateSSSE3(const char* p_Data, size_t p_Size)
+        {
+            StateSSSE3 state = { _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128() };
+
+            size_t i = 0;
+            for (; i + 16 <= p_Size; i += 16)
+                CheckSSSE3(state, _mm_loadu_si128((const __m128i*)(p_Data + i)));
+
+            // zero padding is ascii, so a sequence cut by the end still shows up as too short
+            if (i < p_Size)
+            {
+                alignas(16) char tail[16] = {};
+                std::memcpy(tail, p_Data + i, p_Size - i);
+                CheckSSSE3(state, _mm_load_si128((const __m128i*)tail));
+            }
+
+            __m128i error = _mm_or_si128(state.Error, state.PrevIncomplete);
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) == 0xFFFF;
+        }
+
+        struct StateAVX2
+        {
+            __m256i Error;
+            __m256i PrevInput;
+            __m256i PrevIncomplete;
+        };
+
+        SCPY_TARGET("avx2")
+        void CheckAVX2(StateAVX2& p_State, __m256i p_Input)
+        {
+            if (_mm256_movemask_epi8(p_Input) == 0)
+            {
+                p_State.Error = _mm256_or_si256(p_State.Error, p_State.PrevIncomplete);
+                p_State.PrevIncomplete = _mm256_setzero_si256();
+                p_State.PrevInput = p_Input;
+                return;
+            }
+
+            const __m256i nibble = _mm256_set1_epi8(0x0F);
+            const __m256i byte1High = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)s_Byte1High));
+            const __m256i byte1Low = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)s_Byte1Low));
+            const __m256i byte2High = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)s_Byte2High));
+
+            // alignr works per 128 bit lane, so the lane below comes from the previous block's high half
+            __m256i shifted = _mm256_permute2x128_si256(p_State.PrevInput, p_Input, 0x21);
+            __m256i prev1 = _mm256_alignr_epi8(p_Input, shifted, 15);
+            __m256i prev2 = _mm256_alignr_epi8(p_Input, shifted, 14);
+            __m256i prev3 = _mm256_alignr_epi8(p_Input, shifted, 13);
+
+            __m256i special = _mm256_and_si256(
+                _mm256_and_si256(
+                    _mm256_shuffle_epi8(byte1High, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+                    _mm256_shuffle_epi8(byte1Low, _mm256_and_si256(prev1, nibble))),
+                _mm256_shuffle_epi8(byte2High, _mm256_and_si256(_mm256_srli_epi16(p_Input, 4), nibble)));
+
+            __m256i thirdByte = _mm256_subs_epu8(prev2, _mm256_set1_epi8((char)(0xE0 - 0x80)));
+            __m256i fourthByte = _mm256_subs_epu8(prev3, _mm256_set1_epi8((char)(0xF0 - 0x80)));
+            __m256i mustBeContinuation = _mm256_and_si256(_mm256_or_si256(thirdByte, fourthByte), _mm256_set1_epi8((char)0x80));
+
+            p_State.Error = _mm256_or_si256(p_State.Error, _mm256_xor_si256(mustBeContinuation, special));
+
+            const __m256i maxValue = _mm256_setr_epi8(
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, (char)0xEF, (char)0xDF, (char)0xBF);
+            p_State.PrevIncomplete = _mm256_subs_epu8(p_Input, maxValue);
+            p_State.PrevInput = p_Input;
+        }
+
+        SCPY_TARGET("avx2")
+        bool ValidateAVX2(const char* p_Data, size_t p_Size)
+        {
+            StateAVX2 state = { _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256() };
+
+            size_t i = 0;
+            for (; i + 32 <= p_Size; i += 32)
+                CheckAVX2(state, _mm256_loadu_si256((const __m256i*)(p_Data + i)));
+
+            if (i < p_Size)
+            {
+                alignas(32) char tail[32] = {};
+                std::memcpy(tail, p_Data + i, p_Size - i);
+                CheckAVX2(state, _mm256_load_si256((const __m256i*)tail));
+            }
+
+            __m256i error = _mm256_or_si256(state.Error, state.PrevIncomplete);
+            return _mm256_testz_si256(error, error) != 0;
+        }
+    #endif
+
+        using ValidateFn = bool(*)(const char*, size_t);
+
+        ValidateFn SelectValidator()
+        {
+        #ifdef SCPY_X86
+            if (HasAVX2())
+                return ValidateAVX2;
+            if (HasSSSE3())
+                return ValidateSSSE3;
+        #endif
+            return IsValidUtf8Scalar;
+        }
+
+        struct Utf8Sequence
+        {
+            char Bytes[3];
+            uint8_t Size;
+        };
+
+        // code points of 0x80-0x9F, the five bytes Windows-1252 leaves undefined keep their Latin-1 meaning
+        constexpr char16_t s_Windows1252High[32] = {
+            0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021, 0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+            0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014, 0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178
+        };
+
+        constexpr auto s_Windows1252Table = []()
+        {
+            std::array<Utf8Sequence, 128> table{};
+            for (uint32_t byte = 0x80; byte <= 0xFF; byte++)
+            {
+                uint32_t codePoint = byte < 0xA0 ? s_Windows1252High[byte - 0x80] : byte;
+                Utf8Sequence& sequence = table[byte - 0x80];
+
+                if (codePoint < 0x800)
+                {
+                    sequence.Bytes[0] = (char)(0xC0 | (codePoint >> 6));
+                    sequence.Bytes[1] = (char)(0x80 | (codePoint & 0x3F));
+                    sequence.Size = 2;
+                }
+                else
+                {
+                    sequence.Bytes[0] = (char)(0xE0 | (codePoint >> 12));
+                    sequence.Bytes[1] = (char)(0x80 | ((codePoint >> 6) & 0x3F));
+                    sequence.Bytes[2] = (char)(0x80 | (codePoint & 0x3F));
+                    sequence.Size = 3;
+                }
+            }
+            return table;
+        }();
+
+    #ifndef _WIN32
+        class IconvCache
+        {
+            public:
+                ~IconvCache()
+                {
+                    for (auto& [key, descriptor] : m_Descriptors)
+                    {
+                        if (descriptor != (iconv_t)-1)
+                            iconv_close(descriptor);
+                    }
+                }
+
+                // failures are cached too, an unknown charset is only looked up once
+                iconv_t Get(const char* p_To, const std::string& p_From)
+                {
+                    std::string key = std::string(p_To) + '|' + p_From;
+
+                    auto it = m_Descriptors.find(key);
+                    if (it == m_Descriptors.end())
+                    {
+                        iconv_t descriptor = iconv_open(p_To, p_From.c_str());
+                        if (descriptor == (iconv_t)-1)
+                            LOG("ERROR: iconv cannot convert from {} to {}", p_From, p_To);
+
+                        it = m_Descriptors.emplace(std::move(key), descriptor).first;
+                    }
+
+                    return it->second;
+                }
+
+            private:
+                std::unordered_map<std::string, iconv_t> m_Descriptors;
+        };
+
+        IconvCache& GetIconvCache()
+        {
+            thread_local IconvCache s_Cache;
+            return s_Cache;
+        }
+    #endif
+
+    } // namespace
+
+    bool IsValidUtf8Scalar(const char* p_Data, size_t p_Size)
+    {
+        const unsigned char* data = (const unsigned char*)p_Data;
+
+        size_t i = 0;
+        while (i < p_Size)
+        {
+            if (i + 8 <= p_Size && IsAscii8(p_Data + i))
+            {
+                i += 8;
+                continue;
+            }
+
+            unsigned char lead = data[i];
+            size_t length = GetSequenceLength(lead);
+            if (length == 0 || i + length > p_Size)
+                return false;
+
+            if (length > 1)
+            {
+                // the second byte range is narrower after E0, ED, F0 and F4
+                unsigned char low = 0x80, high = 0xBF;
+                if (lead == 0xE0) low = 0xA0;
+                else if (lead == 0xED) high = 0x9F;
+                else if (lead == 0xF0) low = 0x90;
+                else if (lead == 0xF4) high = 0x8F;
+
+                if (data[i + 1] < low || data[i + 1] > high)
+                    return false;
+
+                for (size_t j = 2; j < length; j++)
+                {
+                    if ((data[i + j] & 0xC0) != 0x80)
+                        return false;
+                }
+            }
+
+            i += length;
+        }
+
+        return true;
+    }
+
+    bool IsValidUtf8(const char* p_Data, size_t p_Size)
+    {
+        static const ValidateFn s_Validate = SelectValidator();
+        return s_Validate(p_Data, p_Size);
+    }
+
+    void Windows1252ToUtf8(std::string_view p_Input, std::string& p_Output)
+    {
+        p_Output.resize(p_Input.size() * 3);
+        char* out = p_Output.data();
+
+        size_t i = 0;
+        while (i < p_Input.size())
+        {
+            if (i + 8 <= p_Input.size() && IsAscii8(p_Input.data() + i))
+            {
+                std::memcpy(out, p_Input.data() + i, 8);
+                out += 8;
+                i += 8;
+                continue;
+            }
+
+            unsigned char c = (unsigned char)p_Input[i++];
+            if (c < 0x80)
+            {
+                *out++ = (char)c;
+                continue;
+            }
+
+            const Utf8Sequence& sequence = s_Windows1252Table[c - 0x80];
+            std::memcpy(out, sequence.Bytes, 3);
+            out += sequence.Size;
+        }
+
+        p_Output.resize(out - p_Output.data());
+    }
+
+    TextEncoding ResolveCharset(std::string_view p_Label)
+    {
+        std::string label;
+        for (char c : p_Label)
+        {
+            if (c != '"' && c != '\'' && c != ' ')
+                label.push_back((char)std::tolower((unsigned char)c));
+        }
+
+        if (label == "utf-8" || label == "utf8" || label == "unicode-1-1-utf-8")
+            return TextEncoding::Utf8;
+
+        static const char* s_Windows1252Labels[] = { 
+            "windows-1252", "cp1252", "x-cp1252", "iso-8859-1", "iso8859-1", "iso_8859-1", "latin1", "l1", "us-ascii", "ascii" 
+        };
+        for (const char* windows1252 : s_Windows1252Labels)
+        {
+            if (label == windows1252)
+                return TextEncoding::Windows1252;
+        }
+
+        return TextEncoding::Other;
+    }
+
+    std::string_view FindCharsetParameter(std::string_view p_ContentType)
+    {
+        for (size_t i = 0; i + 8 <= p_ContentType.size(); i++)
+        {
+            std::string_view name = p_ContentType.substr(i, 8);
+            bool matches = std::equal(name.begin(), name.end(), "charset=", [](char a, char b) { return std::tolower((unsigned char)a) == b; });
+            if (!matches)
+                continue;
+
+            std::string_view value = p_ContentType.substr(i + 8);
+            size_t start = value.find_first_not_of(" \"'");
+            if (start == std::string_view::npos)
+                return {};
+
+            value = value.substr(start);
+            return value.substr(0, value.find_first_of(" \"';>/\t\r\n"));
+        }
+
+        return {};
+    }
+
+    std::string_view FindMetaCharset(std::string_view p_Html)
+    {
+        auto lower = [](char c) { return (char)std::tolower((unsigned char)c); };
+
+        for (size_t i = 0; i + 5 <= p_Html.size(); i++)
+        {
+            if (p_Html[i] != '<' || lower(p_Html[i + 1]) != 'm' || lower(p_Html[i + 2]) != 'e' || lower(p_Html[i + 3]) != 't' || lower(p_Html[i + 4]) != 'a')
+                continue;
+
+            size_t end = p_Html.find('>', i);
+            if (end == std::string_view::npos)
+                return {};
+
+            std::string_view charset = FindCharsetParameter(p_Html.substr(i, end - i));
+            if (!charset.empty())
+                return charset;
+
+            i = end;
+        }
+
+        return {};
+    }
+
+    size_t CountHighBytes(std::string_view p_Text)
+    {
+        size_t count = 0;
+        for (char c : p_Text)
+            count += (unsigned char)c >= 0x80;
+        return count;
+    }
+
+    TextEncoding SniffEncoding(std::string_view p_Sample)
+    {
+        Utf8Validator validator;
+        validator.Feed(p_Sample);
+
+        return validator.IsValid() ? TextEncoding::Utf8 : TextEncoding::Windows1252;
+    }
+
+    bool CharsetDecoder::Begin(const std::string& p_From)
+    {
+        m_Descriptor = nullptr;
+        m_Carry.clear();
+
+    #ifdef _WIN32
+        (void)p_From;
+        return false;
+    #else
+        iconv_t descriptor = GetIconvCache().Get("UTF-8", p_From);
+        if (descriptor == (iconv_t)-1)
+            return false;
+
+        // drop any shift state the last body left behind
+        iconv(descriptor, nullptr, nullptr, nullptr, nullptr);
+
+        m_Descriptor = (void*)descriptor;
+        return true;
+    #endif
+    }
+
+    bool CharsetDecoder::Convert(std::string_view p_Chunk, std::string& p_Output)
+    {
+        p_Output.clear();
+        if (!m_Descriptor)
+            return false;
+
+    #ifdef _WIN32
+        (void)p_Chunk;
+        return false;
+    #else
+        std::string_view input = p_Chunk;
+        if (!m_Carry.empty())
+        {
+            m_Carry.append(p_Chunk);
+            input = m_Carry;
+        }
+
+        char* in = const_cast<char*>(input.data());
+        size_t inLeft = input.size();
+
+        size_t written = 0;
+        p_Output.resize(std::max(p_Output.capacity(), input.size() * 2 + 16));
+
+        while (inLeft > 0)
+        {
+            char* out = p_Output.data() + written;
+            size_t outLeft = p_Output.size() - written;
+
+            size_t result = iconv((iconv_t)m_Descriptor, &in, &inLeft, &out, &outLeft);
+            written = p_Output.size() - outLeft;
+
+            if (result != (size_t)-1)
+                break;
+
+            if (errno == E2BIG)
+                p_Output.resize(p_Output.size() * 2);
+            else if (errno == EINVAL)
+                break; // the rest is the start of a sequence the next chunk finishes
+            else
+            {
+                // not valid in this charset, skip the byte and mark it like a browser would
+                in++;
+                inLeft--;
+                if (p_Output.size() - written < 3)
+                    p_Output.resize(p_Output.size() * 2);
+                std::memcpy(p_Output.data() + written, "\xEF\xBF\xBD", 3);
+                written += 3;
+            }
+        }
+
+        std::string carry(in, inLeft);
+        m_Carry.swap(carry);
+
+        p_Output.resize(written);
+        return true;
+    #endif
+    }
+
+    void Utf8Validator::Reset()
+    {
+        m_PendingSize = 0;
+        m_Valid = true;
+    }
+
+    void Utf8Validator::Feed(std::string_view p_Chunk)
+    {
+        if (!m_Valid || p_Chunk.empty())
+            return;
+
+        // finish the sequence the last chunk cut
+        if (m_PendingSize > 0)
+        {
+            size_t length = GetSequenceLength((unsigned char)m_Pending[0]);
+            size_t take = std::min(length - m_PendingSize, p_Chunk.size());
+
+            std::memcpy(m_Pending + m_PendingSize, p_Chunk.data(), take);
+            m_PendingSize += (uint8_t)take;
+            p_Chunk.remove_prefix(take);
+
+            if (m_PendingSize < length)
+                return;
+
+            m_Valid = IsValidUtf8Scalar(m_Pending, m_PendingSize);
+            m_PendingSize = 0;
+            if (!m_Valid)
+                return;
+        }
+
+        // keep back a sequence that runs past this chunk
+        size_t split = p_Chunk.size();
+        for (size_t back = 1; back <= std::min<size_t>(3, p_Chunk.size()); back++)
+        {
+            unsigned char c = (unsigned char)p_Chunk[p_Chunk.size() - back];
+            if ((c & 0xC0) == 0x80)
+                continue;
+
+            if (c >= 0xC0 && GetSequenceLength(c) > back)
+                split = p_Chunk.size() - back;
+            break;
+        }
+
+        m_Valid = IsValidUtf8(p_Chunk.data(), split);
+
+        m_PendingSize = (uint8_t)(p_Chunk.size() - split);
+        std::memcpy(m_Pending, p_Chunk.data() + split, m_PendingSize);
+    }
+
+    bool Utf8Validator::Finish()
+    {
+        if (m_PendingSize > 0)
+            m_Valid = false;
+
+        m_PendingSize = 0;
+        return m_Valid;
+    }
+
+} // namespace SCPY
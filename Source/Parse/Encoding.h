@@ -0,0 +1,75 @@
+#pragma once
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+
+
+namespace SCPY
+{
+    enum class TextEncoding : uint8_t
+    {
+        Utf8, Windows1252, Other // Other goes through iconv by name
+    };
+
+    // WHATWG style labels, Latin-1 and ASCII resolve to Windows-1252 like browsers do
+    TextEncoding ResolveCharset(std::string_view p_Label);
+
+    // "text/html; charset=ISO-8859-1" -> "ISO-8859-1", empty when there is none
+    std::string_view FindCharsetParameter(std::string_view p_ContentType);
+
+    // <meta charset="..."> or <meta http-equiv="Content-Type" content="...; charset=...">
+    std::string_view FindMetaCharset(std::string_view p_Html);
+
+    // Guess from the bytes alone: high bytes that all form UTF-8 sequences mean UTF-8, anything else Windows-1252.
+    // A sequence cut by the end of the sample is not held against it.
+    TextEncoding SniffEncoding(std::string_view p_Sample);
+    size_t CountHighBytes(std::string_view p_Text);
+
+    // Vectorized when the cpu has SSSE3 or AVX2, rejects overlongs, surrogates and truncated sequences
+    bool IsValidUtf8(const char* p_Data, size_t p_Size);
+    inline bool IsValidUtf8(std::string_view p_Text) { return IsValidUtf8(p_Text.data(), p_Text.size()); }
+    bool IsValidUtf8Scalar(const char* p_Data, size_t p_Size);
+
+    // Table driven, Latin-1 goes through here too since Windows-1252 only adds printable characters over its C1 range
+    void Windows1252ToUtf8(std::string_view p_Input, std::string& p_Output);
+
+    // Streams a body in a legacy charset to UTF-8 through iconv, where the platform has it.
+    // Descriptors are opened once per thread and charset pair and reset between bodies,
+    // a multibyte sequence cut between two chunks is carried over to the next one.
+    class CharsetDecoder
+    {
+        public:
+            // False when the charset is unknown or there is no iconv
+            bool Begin(const std::string& p_From);
+
+            // p_Output is overwritten but keeps its capacity, so a reused buffer stops allocating
+            bool Convert(std::string_view p_Chunk, std::string& p_Output);
+
+        private:
+            void* m_Descriptor = nullptr;
+            std::string m_Carry;
+    };
+
+    // Validates a body that arrives in pieces, a sequence may be split between two chunks
+    class Utf8Validator
+    {
+        public:
+            void Reset();
+            void Feed(std::string_view p_Chunk);
+
+            // False when something was invalid or the body stopped in the middle of a sequence
+            bool Finish();
+
+            bool IsValid() const { return m_Valid; }
+
+        private:
+            char m_Pending[4] = {};
+            uint8_t m_PendingSize = 0;
+            bool m_Valid = true;
+    };
+
+} // namespace SCPY
@@ -0,0 +1,93 @@
+#include "ExtractionPlan.h"
+#include "Core/Base.h"
+
+
+
+namespace SCPY
+{
+    namespace
+    {
+        bool HasClass(std::string_view p_Classes, std::string_view p_Token)
+        {
+            size_t start = 0;
+            while (start < p_Classes.size())
+            {
+                size_t end = p_Classes.find_first_of(" \t\r\n\f", start);
+                if (end == std::string_view::npos)
+                    end = p_Classes.size();
+
+                if (p_Classes.substr(start, end - start) == p_Token)
+                    return true;
+
+                start = end + 1;
+            }
+
+            return false;
+        }
+
+    } // namespace
+
+    ExtractionPlan::ExtractionPlan(std::vector<PlanRule> p_Rules)
+        : m_Rules(std::move(p_Rules))
+    {
+        m_Parser = lxb_css_parser_create();
+        m_Selectors = lxb_selectors_create();
+        if (lxb_css_parser_init(m_Parser, nullptr) != LXB_STATUS_OK || lxb_selectors_init(m_Selectors) != LXB_STATUS_OK)
+        {
+            LOG("ERROR: Failed to create the css selector engine");
+            return;
+        }
+
+        // an element matching several rules is reported once
+        lxb_selectors_opt_set(m_Selectors, LXB_SELECTORS_OPT_MATCH_FIRST);
+
+        std::string selectors;
+        for (const auto& rule : m_Rules)
+        {
+            if (!selectors.empty())
+                selectors += ", ";
+            selectors += rule.Selector;
+        }
+
+        m_List = lxb_css_selectors_parse(m_Parser, (const lxb_char_t*)selectors.data(), selectors.size());
+        if (!m_List)
+            LOG("ERROR: Invalid extraction selectors '{}'", selectors);
+    }
+
+    ExtractionPlan::~ExtractionPlan()
+    {
+        if (m_List)
+            lxb_css_selector_list_destroy_memory(m_List);
+        if (m_Selectors)
+            lxb_selectors_destroy(m_Selectors, true);
+        if (m_Parser)
+            lxb_css_parser_destroy(m_Parser, true);
+    }
+
+    std::vector<PlanRule> ExtractionPlan::GetDefaultRules()
+    {
+        return {
+            { ".numDocs",                   "numDocs",      PlanAction::Counter },
+            { ".paragrafoBRS > .docTitulo", "docTitulo",    PlanAction::Label },
+            { ".paragrafoBRS > .docTexto",  "docTexto",     PlanAction::Value },
+        };
+    }
+
+    const PlanRule* ExtractionPlan::FindRule(lxb_dom_element_t* p_Element) const
+    {
+        size_t length = 0;
+        const lxb_char_t* value = lxb_dom_element_get_attribute(p_Element, (const lxb_char_t*)"class", 5, &length);
+        if (!value)
+            return nullptr;
+
+        std::string_view classes((const char*)value, length);
+        for (const auto& rule : m_Rules)
+        {
+            if (HasClass(classes, rule.Class))
+                return &rule;
+        }
+
+        return nullptr;
+    }
+
+} // namespace SCPY
@@ -0,0 +1,88 @@
+#pragma once
+
+// lib
+#include <lexbor/html/html.h>
+#include <lexbor/css/css.h>
+#include <lexbor/selectors/selectors.h>
+
+// std
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+
+namespace SCPY
+{
+    enum class PlanAction : uint8_t
+    {
+        Counter,    // the result counter, only its first match counts
+        Label,      // a docTitulo, names the field of the next value
+        Value       // a docTexto
+    };
+
+    struct PlanRule
+    {
+        std::string Selector;
+        std::string Class; // class token that tells the rule's matches apart
+        PlanAction Action;
+    };
+
+    // Every rule's selector compiled once into a single lexbor selector list,
+    // so one walk over the page finds all matches, in document order.
+    class ExtractionPlan
+    {
+        public:
+            explicit ExtractionPlan(std::vector<PlanRule> p_Rules);
+            ~ExtractionPlan();
+
+            ExtractionPlan(const ExtractionPlan&) = delete;
+            ExtractionPlan& operator=(const ExtractionPlan&) = delete;
+
+            bool IsValid() const { return m_List != nullptr; }
+
+            // p_Handler(const PlanRule&, lxb_dom_element_t*) for every element that matches a rule
+            template<typename F>
+            bool Run(lxb_dom_node_t* p_Root, F&& p_Handler) const
+            {
+                if (!IsValid()) return false;
+
+                struct Context
+                {
+                    const ExtractionPlan* Plan;
+                    F* Handler;
+                } context = { this, &p_Handler };
+
+                auto callback = [](lxb_dom_node_t* p_Node, lxb_css_selector_specificity_t, void* p_Context) -> lxb_status_t
+                {
+                    Context* context = (Context*)p_Context;
+
+                    lxb_dom_element_t* element = lxb_dom_interface_element(p_Node);
+                    const PlanRule* rule = context->Plan->FindRule(element);
+                    if (rule)
+                        (*context->Handler)(*rule, element);
+
+                    return LXB_STATUS_OK;
+                };
+
+                return lxb_selectors_find(m_Selectors, p_Root, m_List, callback, &context) == LXB_STATUS_OK;
+            }
+
+            const std::vector<PlanRule>& GetRules() const { return m_Rules; }
+
+            // The SCON result page layout
+            static std::vector<PlanRule> GetDefaultRules();
+
+        private:
+            const PlanRule* FindRule(lxb_dom_element_t* p_Element) const;
+
+        private:
+            std::vector<PlanRule> m_Rules;
+
+            lxb_css_parser_t* m_Parser = nullptr;
+            lxb_selectors_t* m_Selectors = nullptr;
+            lxb_css_selector_list_t* m_List = nullptr;
+    };
+
+} // namespace SCPY
@@ -0,0 +1,241 @@
+#include "ExtractionSchema.h"
+#include "Core/Base.h"
+
+// lib
+#include <yaml-cpp/yaml.h>
+
+// std
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+
+
+
+namespace SCPY
+{
+    namespace
+    {
+        static_assert(std::size(s_LawsuitFieldNames) == size_t(LawsuitField::Count));
+
+        constexpr std::string_view s_ActionNames[] = { "Counter", "Label", "Value" };
+
+        template<typename T, size_t N>
+        std::optional<T> FindName(const std::string_view (&p_Names)[N], const std::string& p_Name)
+        {
+            for (size_t i = 0; i < N; i++)
+            {
+                if (p_Names[i] == p_Name)
+                    return T(i);
+            }
+
+            return std::nullopt;
+        }
+
+    } // namespace
+
+    std::string ExtractionSchema::FormatUrl(const std::string& p_Term, int p_DocsPerPage, int p_Page) const
+    {
+        std::string search = p_Term;
+        std::replace(search.begin(), search.end(), ' ', '+');
+
+        std::string searchUpper = search;
+        std::transform(searchUpper.begin(), searchUpper.end(), searchUpper.begin(), [](unsigned char c) { return (char)std::toupper(c); });
+
+        const std::string& pattern = p_Page == 0 ? HomeUrl : PageUrl;
+
+        std::string url;
+        url.reserve(pattern.size() + search.size() * 2);
+
+        size_t position = 0;
+        while (position < pattern.size())
+        {
+            size_t open = pattern.find('{', position);
+            size_t close = open == std::string::npos ? std::string::npos : pattern.find('}', open);
+            if (close == std::string::npos)
+            {
+                url.append(pattern, position);
+                break;
+            }
+
+            url.append(pattern, position, open - position);
+
+            std::string_view name = std::string_view(pattern).substr(open + 1, close - open - 1);
+            if (name == "term")
+                url += search;
+            else if (name == "TERM")
+                url += searchUpper;
+            else if (name == "docs")
+                url += std::to_string(p_DocsPerPage);
+            else if (name == "offset")
+                url += std::to_string(p_DocsPerPage * p_Page + 1);
+            else
+                url.append(pattern, open, close - open + 1);
+
+            position = close + 1;
+        }
+
+        return url;
+    }
+
+    bool ExtractionSchema::Validate() const
+    {
+        if (HomeUrl.empty() || PageUrl.empty())
+        {
+            LOG("ERROR: The schema needs both a HomeUrl and a PageUrl");
+            return false;
+        }
+
+        for (const auto& rule : Rules)
+        {
+            if (rule.Class.empty())
+            {
+                LOG("ERROR: Rule '{}' has no Class to tell its matches apart", rule.Selector);
+                return false;
+            }
+        }
+
+        bool hasLabel = std::any_of(Rules.begin(), Rules.end(), [](const PlanRule& p_Rule) { return p_Rule.Action == PlanAction::Label; });
+        bool hasValue = std::any_of(Rules.begin(), Rules.end(), [](const PlanRule& p_Rule) { return p_Rule.Action == PlanAction::Value; });
+        if (!hasLabel || !hasValue)
+        {
+            LOG("ERROR: The schema needs at least one Label and one Value rule");
+            return false;
+        }
+
+        bool hasCase = std::any_of(Labels.begin(), Labels.end(), [](const FieldLabel& p_Label) { return p_Label.Field == LawsuitField::Case; });
+        if (!hasCase)
+        {
+            LOG("ERROR: No label maps to Case, which starts every record");
+            return false;
+        }
+
+        return ExtractionPlan(Rules).IsValid();
+    }
+
+    void ExtractionSchema::Write(YAML::Emitter& p_Out) const
+    {
+        p_Out << YAML::BeginMap;
+        p_Out << YAML::Key << "HomeUrl" << YAML::Value << HomeUrl;
+        p_Out << YAML::Key << "PageUrl" << YAML::Value << PageUrl;
+
+        p_Out << YAML::Key << "Rules" << YAML::Value << YAML::BeginSeq;
+        for (const auto& rule : Rules)
+        {
+            p_Out << YAML::Flow << YAML::BeginMap;
+            p_Out << YAML::Key << "Selector" << YAML::Value << rule.Selector;
+            p_Out << YAML::Key << "Class" << YAML::Value << rule.Class;
+            p_Out << YAML::Key << "Action" << YAML::Value << std::string(s_ActionNames[size_t(rule.Action)]);
+            p_Out << YAML::EndMap;
+        }
+        p_Out << YAML::EndSeq;
+
+        p_Out << YAML::Key << "Labels" << YAML::Value << YAML::BeginMap;
+        for (const auto& label : Labels)
+            p_Out << YAML::Key << label.Label << YAML::Value << std::string(s_LawsuitFieldNames[size_t(label.Field)]);
+        p_Out << YAML::EndMap;
+
+        p_Out << YAML::EndMap;
+    }
+
+    std::optional<ExtractionSchema> ExtractionSchema::Read(const YAML::Node& p_Node)
+    {
+        try
+        {
+            ExtractionSchema schema;
+            schema.HomeUrl = p_Node["HomeUrl"].as<std::string>();
+            schema.PageUrl = p_Node["PageUrl"].as<std::string>();
+
+            for (const auto& node : p_Node["Rules"])
+            {
+                std::string action = node["Action"].as<std::string>();
+                auto parsed = FindName<PlanAction>(s_ActionNames, action);
+                if (!parsed)
+                {
+                    LOG("ERROR: Unknown rule action '{}'", action);
+                    return std::nullopt;
+                }
+
+                schema.Rules.push_back({ node["Selector"].as<std::string>(), node["Class"].as<std::string>(), *parsed });
+            }
+
+            for (const auto& node : p_Node["Labels"])
+            {
+                std::string field = node.second.as<std::string>();
+                auto parsed = FindName<LawsuitField>(s_LawsuitFieldNames, field);
+                if (!parsed)
+                {
+                    LOG("ERROR: Unknown lawsuit field '{}'", field);
+                    return std::nullopt;
+                }
+
+                schema.Labels.push_back({ node.first.as<std::string>(), *parsed });
+            }
+
+            if (!schema.Validate())
+                return std::nullopt;
+
+            return schema;
+        }
+        catch (const YAML::Exception& e)
+        {
+            LOG("ERROR: Failed to read extraction schema: {}", e.what());
+            return std::nullopt;
+        }
+    }
+
+    bool ExtractionSchema::Save(const std::filesystem::path& p_Path) const
+    {
+        YAML::Emitter out;
+        Write(out);
+
+        std::ofstream file(p_Path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            LOG("ERROR: Failed to write extraction schema {}", p_Path.string());
+            return false;
+        }
+
+        file << out.c_str() << '\n';
+        return bool(file);
+    }
+
+    std::optional<ExtractionSchema> ExtractionSchema::Load(const std::filesystem::path& p_Path)
+    {
+        if (!std::filesystem::exists(p_Path))
+            return std::nullopt;
+
+        try
+        {
+            return Read(YAML::LoadFile(p_Path.string()));
+        }
+        catch (const YAML::Exception& e)
+        {
+            LOG("ERROR: Failed to read extraction schema {}: {}", p_Path.string(), e.what());
+            return std::nullopt;
+        }
+    }
+
+    const std::shared_ptr<const ExtractionSchema>& ExtractionSchema::GetDefault()
+    {
+        static const std::shared_ptr<const ExtractionSchema> s_Default = []()
+        {
+            auto schema = std::make_shared<ExtractionSchema>();
+            schema->HomeUrl = "https://scon.stj.jus.br/SCON/pesquisar.jsp?pesquisaAmigavel=+{term}&b=ACOR&tp=T&numDocsPagina={docs}&i=1&O=&ref=&processo=&ementa=&nota=&filtroPorNota=&orgao=&relator=&uf=&classe=&juizo=&data=&dtpb=&dtde=&operador=e&thesaurus=JURIDICO&p=true&livre={term}";
+            schema->PageUrl = "https://scon.stj.jus.br/SCON/jurisprudencia/toc.jsp?numDocsPagina={docs}&tipo_visualizacao=&filtroPorNota=&ref=&data=&p=true&b=ACOR&pesquisaAmigavel=+{term}&thesaurus=JURIDICO&i={offset}&l={docs}&tp=T&operador=e&livre={TERM}&b=ACOR";
+            schema->Rules = ExtractionPlan::GetDefaultRules();
+            schema->Labels = {
+                { "Processo",                   LawsuitField::Case },
+                { "Relator",                    LawsuitField::Rapporteur },
+                { "Relatora",                   LawsuitField::Rapporteur },
+                { "Data do Julgamento",         LawsuitField::JudgmentDate },
+                { "Data da Publicação/Fonte",   LawsuitField::PubDate },
+                { "Ementa",                     LawsuitField::Headnote },
+                { "Acórdão",                    LawsuitField::Decision },
+            };
+            return schema;
+        }();
+
+        return s_Default;
+    }
+
+} // namespace SCPY
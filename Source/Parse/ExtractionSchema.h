@@ -0,0 +1,48 @@
+#pragma once
+#include "ExtractionPlan.h"
+#include "LabelMatcher.h"
+
+// std
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+
+
+namespace YAML
+{
+    class Node;
+    class Emitter;
+}
+
+namespace SCPY
+{
+    // Where SCON's results are and how its markup reads, so a layout change is a config edit instead of a rebuild.
+    struct ExtractionSchema
+    {
+        // {term} is the term with '+' for spaces, {TERM} the same in upper case,
+        // {docs} the page size and {offset} the position of the page's first document (1 based)
+        std::string HomeUrl;
+        std::string PageUrl;
+
+        std::vector<PlanRule> Rules;
+        std::vector<FieldLabel> Labels;
+
+        std::string FormatUrl(const std::string& p_Term, int p_DocsPerPage, int p_Page) const;
+
+        // Compiles the selectors once, false (and a log) when the schema could not extract anything
+        bool Validate() const;
+
+        void Write(YAML::Emitter& p_Out) const;
+        static std::optional<ExtractionSchema> Read(const YAML::Node& p_Node);
+
+        bool Save(const std::filesystem::path& p_Path) const;
+        static std::optional<ExtractionSchema> Load(const std::filesystem::path& p_Path);
+
+        // The SCON layout the parser was written against
+        static const std::shared_ptr<const ExtractionSchema>& GetDefault();
+    };
+
+} // namespace SCPY
@@ -0,0 +1,278 @@
+#include "HtmlParser.h"
+#include "Whitespace.h"
+#include "Encoding.h"
+#include "Core/Search.h"
+
+// lib
+#include <lexbor/html/html.h>
+
+// std
+#include <cstdint>
+#include <string>
+
+
+
+namespace SCPY
+{
+    namespace 
+    {
+        // Calls p_Callback with every text node under p_Parent in document order, straight from lexbor's buffers
+        template<typename F>
+        void ForEachText(lxb_dom_node_t* p_Parent, F&& p_Callback)
+        {
+            lxb_dom_node_t* node = p_Parent->first_child;
+            while (node)
+            {
+                if (node->type == LXB_DOM_NODE_TYPE_TEXT)
+                {
+                    const lexbor_str_t& data = lxb_dom_interface_character_data(node)->data;
+                    p_Callback(std::string_view((const char*)data.data, data.length));
+                }
+
+                if (node->first_child)
+                {
+                    node = node->first_child;
+                    continue;
+                }
+
+                while (node != p_Parent && !node->next)
+                    node = node->parent;
+
+                node = node != p_Parent ? node->next : nullptr;
+            }
+        }
+
+        // the document is UTF-8 by now, whatever the response was in
+        void ReadText(lxb_dom_node_t* p_Node, std::string& p_Output)
+        {
+            p_Output.clear();
+            ForEachText(p_Node, [&](std::string_view p_Text) { p_Output.append(p_Text); });
+
+            NormalizeWhitespace(p_Output);
+        }
+
+        // (ex: "15.575 acórdãos" -> 15575)
+        bool ReadCounter(lxb_dom_node_t* p_Node, size_t& p_Total)
+        {
+            size_t total = 0;
+            bool found = false;
+            ForEachText(p_Node, [&](std::string_view p_Text)
+            {
+                for (char c : p_Text)
+                {
+                    if (c >= '0' && c <= '9')
+                    {
+                        total = total * 10 + (c - '0');
+                        found = true;
+                    }
+                }
+            });
+
+            if (found)
+                p_Total = total;
+            return found;
+        }
+
+    } // namespace
+
+    HtmlParser::HtmlParser()
+    {
+        SetSchema(ExtractionSchema::GetDefault());
+    }
+
+    HtmlParser::~HtmlParser()
+    {
+        if (m_Document)
+            lxb_html_document_destroy(m_Document);
+    }
+
+    HtmlParser& HtmlParser::GetThreadParser()
+    {
+        thread_local HtmlParser parser;
+        return parser;
+    }
+
+    bool HtmlParser::Begin()
+    {
+        if (!m_Document)
+        {
+            m_Document = lxb_html_document_create();
+            if (!m_Document)
+                return false;
+        }
+
+        // a retried download leaves the previous attempt half parsed
+        if (m_Parsing)
+            lxb_html_document_parse_chunk_end(m_Document);
+
+        // drops the nodes but keeps the arenas, so the next page reuses their memory
+        lxb_html_document_clean(m_Document);
+
+        m_Head.clear();
+        m_HighBytes = 0;
+        m_Encoding = TextEncoding::Utf8;
+        m_Decided = false;
+
+        m_Parsing = lxb_html_document_parse_chunk_begin(m_Document) == LXB_STATUS_OK;
+        return m_Parsing;
+    }
+
+    bool HtmlParser::Feed(std::string_view p_Chunk)
+    {
+        if (!m_Parsing) return false;
+
+        if (m_Decided)
+            return Write(p_Chunk);
+
+        // hold the start of the body back until it tells what it is encoded in
+        m_Head.append(p_Chunk);
+        m_HighBytes += CountHighBytes(p_Chunk);
+        if (!Decide(false))
+            return true;
+
+        bool written = Write(m_Head);
+        m_Head.clear();
+        return written;
+    }
+
+    void HtmlParser::SetContentType(std::string_view p_ContentType)
+    {
+        std::string_view charset = FindCharsetParameter(p_ContentType);
+        if (!charset.empty() && !m_Decided)
+            UseCharset(charset);
+    }
+
+    bool HtmlParser::End(SearchPage& p_Page)
+    {
+        if (!m_Parsing) return false;
+
+        if (!m_Decided)
+        {
+            Decide(true);
+            Write(m_Head);
+            m_Head.clear();
+        }
+
+        m_Parsing = false;
+        if (lxb_html_document_parse_chunk_end(m_Document) != LXB_STATUS_OK)
+            return false;
+
+        Extract(p_Page);
+        return true;
+    }
+
+    bool HtmlParser::Parse(std::string_view p_Html, SearchPage& p_Page)
+    {
+        return Begin() && Feed(p_Html) && End(p_Page);
+    }
+
+    void HtmlParser::SetSchema(std::shared_ptr<const ExtractionSchema> p_Schema)
+    {
+        if (!p_Schema || p_Schema == m_Schema)
+            return;
+
+        m_Schema = std::move(p_Schema);
+        m_Plan = std::make_unique<ExtractionPlan>(m_Schema->Rules);
+        m_Labels = LabelMatcher(m_Schema->Labels);
+    }
+
+    bool HtmlParser::Decide(bool p_Final)
+    {
+        // the html spec only looks for the meta tag in the first 1024 bytes
+        constexpr size_t prescanSize = 1024;
+        constexpr size_t sniffHighBytes = 16;
+        constexpr size_t maxHeadSize = 64 * 1024;
+
+        if (p_Final || m_Head.size() >= prescanSize)
+        {
+            std::string_view charset = FindMetaCharset(std::string_view(m_Head).substr(0, prescanSize));
+            if (!charset.empty() && UseCharset(charset))
+                return true;
+        }
+
+        // an all ascii head says nothing, wait for some accented text unless it takes too long
+        if (p_Final || m_HighBytes >= sniffHighBytes || m_Head.size() >= maxHeadSize)
+        {
+            m_Encoding = SniffEncoding(m_Head);
+            m_Decided = true;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool HtmlParser::UseCharset(std::string_view p_Label)
+    {
+        TextEncoding encoding = ResolveCharset(p_Label);
+
+        // a charset iconv does not know (or no iconv at all) is left to the sniffer
+        if (encoding == TextEncoding::Other && !m_Decoder.Begin(std::string(p_Label)))
+            return false;
+
+        m_Encoding = encoding;
+        m_Decided = true;
+        return true;
+    }
+
+    bool HtmlParser::Write(std::string_view p_Chunk)
+    {
+        std::string_view utf8 = p_Chunk;
+        switch (m_Encoding)
+        {
+            case TextEncoding::Utf8:
+                break;
+
+            case TextEncoding::Windows1252:
+                Windows1252ToUtf8(p_Chunk, m_Scratch);
+                utf8 = m_Scratch;
+                break;
+
+            case TextEncoding::Other:
+                m_Decoder.Convert(p_Chunk, m_Scratch);
+                utf8 = m_Scratch;
+                break;
+        }
+
+        return lxb_html_document_parse_chunk(m_Document, reinterpret_cast<const lxb_char_t*>(utf8.data()), utf8.size()) == LXB_STATUS_OK;
+    }
+
+    void HtmlParser::Extract(SearchPage& p_Page)
+    {
+        if (!m_Document->body) return;
+
+        bool counted = false;
+        LawsuitField field = LawsuitField::Count;
+
+        // every record starts with the label mapped to Case, the fields after it go into that record
+        m_Plan->Run(lxb_dom_interface_node(m_Document->body), [&](const PlanRule& p_Rule, lxb_dom_element_t* p_Element)
+        {
+            lxb_dom_node_t* node = lxb_dom_interface_node(p_Element);
+            switch (p_Rule.Action)
+            {
+                case PlanAction::Counter:
+                    if (!counted)
+                        counted = ReadCounter(node, p_Page.TotalResults);
+                    break;
+
+                case PlanAction::Label:
+                    ReadText(node, m_Label);
+                    field = m_Labels.Find(m_Label);
+
+                    if (field == LawsuitField::Case)
+                        p_Page.Lawsuits.emplace_back();
+                    break;
+
+                case PlanAction::Value:
+                    if (field != LawsuitField::Count && !p_Page.Lawsuits.empty())
+                    {
+                        ReadText(node, m_Text);
+                        p_Page.Lawsuits.back()[field] = p_Page.Text.Store(m_Text);
+                    }
+
+                    field = LawsuitField::Count;
+                    break;
+            }
+        });
+    }
+
+} // namespace SCPY
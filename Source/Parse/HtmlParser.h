@@ -0,0 +1,78 @@
+#pragma once
+#include "Encoding.h"
+#include "ExtractionPlan.h"
+#include "ExtractionSchema.h"
+#include "LabelMatcher.h"
+
+// lib
+#include <lexbor/html/html.h>
+
+// std
+#include <memory>
+#include <string>
+#include <string_view>
+
+
+
+namespace SCPY
+{
+    struct SearchPage;
+
+    // Incremental SCON result page parser: the body is fed chunk by chunk as it downloads,
+    // so network and parse time overlap and the full response is never buffered.
+    class HtmlParser
+    {
+        public:
+            HtmlParser();
+            ~HtmlParser();
+
+            HtmlParser(const HtmlParser&) = delete;
+            HtmlParser& operator=(const HtmlParser&) = delete;
+
+            // Starts a new document, dropping whatever an unfinished one had
+            bool Begin();
+            bool Feed(std::string_view p_Chunk);
+
+            // Charset declared by the response, it wins over the meta tag and the sniffer. Call before feeding.
+            void SetContentType(std::string_view p_ContentType);
+
+            // Finishes the document and extracts the result counter and the lawsuits into p_Page
+            bool End(SearchPage& p_Page);
+
+            bool Parse(std::string_view p_Html, SearchPage& p_Page);
+
+            // Recompiles the selectors and labels when p_Schema is not the one in use, cheap otherwise
+            void SetSchema(std::shared_ptr<const ExtractionSchema> p_Schema);
+
+            // One per thread, its document is cleaned and reused between pages and its selectors compiled once
+            static HtmlParser& GetThreadParser();
+
+        private:
+            // Settles the body's charset once, from the meta tag or the sniffer
+            bool Decide(bool p_Final);
+            bool UseCharset(std::string_view p_Label);
+
+            // Transcodes to UTF-8 on the way into lexbor
+            bool Write(std::string_view p_Chunk);
+
+            void Extract(SearchPage& p_Page);
+
+        private:
+            lxb_html_document_t* m_Document = nullptr;
+            // lexbor's selector engine is not thread safe, every parser compiles its own plan
+            std::shared_ptr<const ExtractionSchema> m_Schema;
+            std::unique_ptr<ExtractionPlan> m_Plan;
+            LabelMatcher m_Labels;
+            std::string m_Label;
+            std::string m_Text; // the cleaned value, copied once into the page arena
+            std::string m_Scratch;
+
+            std::string m_Head;
+            size_t m_HighBytes = 0;
+            CharsetDecoder m_Decoder;
+            TextEncoding m_Encoding = TextEncoding::Utf8;
+            bool m_Decided = false;
+            bool m_Parsing = false;
+    };
+
+} // namespace SCPY
@@ -0,0 +1,95 @@
+#include "LabelMatcher.h"
+#include "Whitespace.h"
+#include "Core/Base.h"
+
+// std
+#include <limits>
+
+
+
+namespace SCPY
+{
+    LabelMatcher::LabelMatcher(const std::vector<FieldLabel>& p_Labels)
+    {
+        std::vector<std::string> labels;
+        labels.reserve(p_Labels.size());
+        for (const auto& label : p_Labels)
+        {
+            labels.push_back(label.Label);
+            NormalizeWhitespace(labels.back());
+        }
+
+        // every byte the labels use gets its own column, the others all fall into the rejecting one
+        for (const auto& label : labels)
+        {
+            for (char c : label)
+            {
+                uint8_t& byteClass = m_Classes[(uint8_t)c];
+                if (byteClass == 0)
+                    byteClass = (uint8_t)m_ClassCount++;
+            }
+        }
+
+        auto addState = [&]()
+        {
+            m_Next.resize(m_Next.size() + m_ClassCount, 0);
+            m_Accept.push_back(LawsuitField::Count);
+            return uint32_t(m_Accept.size() - 1);
+        };
+
+        addState(); // reject
+        addState(); // start
+
+        for (size_t i = 0; i < labels.size(); i++)
+        {
+            if (labels[i].empty())
+                continue;
+
+            uint32_t state = 1;
+            for (char c : labels[i])
+            {
+                size_t slot = size_t(state) * m_ClassCount + m_Classes[(uint8_t)c];
+                if (m_Next[slot] == 0)
+                {
+                    if (m_Accept.size() > std::numeric_limits<uint16_t>::max())
+                    {
+                        state = 0;
+                        break;
+                    }
+
+                    uint32_t next = addState();
+                    m_Next[slot] = (uint16_t)next;
+                }
+                state = m_Next[slot];
+            }
+
+            if (state == 0)
+            {
+                LOG("ERROR: Too many docTitulo labels, dropping '{}'", labels[i]);
+            }
+            else if (m_Accept[state] != LawsuitField::Count && m_Accept[state] != p_Labels[i].Field)
+            {
+                LOG("WARNING: Label '{}' is mapped twice, keeping the first", labels[i]);
+            }
+            else
+                m_Accept[state] = p_Labels[i].Field;
+        }
+    }
+
+    LawsuitField LabelMatcher::Find(std::string_view p_Label) const
+    {
+        if (m_Next.empty() || p_Label.empty())
+            return LawsuitField::Count;
+
+        uint32_t state = 1;
+        for (char c : p_Label)
+        {
+            state = m_Next[size_t(state) * m_ClassCount + m_Classes[(uint8_t)c]];
+            if (state == 0)
+                return LawsuitField::Count;
+        }
+
+        return m_Accept[state];
+    }
+
+} // namespace SCPY
@@ -0,0 +1,44 @@
+#pragma once
+#include "Core/Search.h"
+
+// std
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+
+namespace SCPY
+{
+    struct FieldLabel
+    {
+        std::string Label; // the docTitulo text, after whitespace normalization
+        LawsuitField Field;
+    };
+
+    // The docTitulo labels compiled into a DFA over byte classes: looking a label up
+    // is one table load per byte, however many labels the schema maps.
+    class LabelMatcher
+    {
+        public:
+            LabelMatcher() = default;
+            explicit LabelMatcher(const std::vector<FieldLabel>& p_Labels);
+
+            // LawsuitField::Count when p_Label is not one of ours
+            LawsuitField Find(std::string_view p_Label) const;
+
+            size_t GetStateCount() const { return m_Accept.size(); }
+
+        private:
+            // 0 for the bytes no label has
+            std::array<uint8_t, 256> m_Classes{};
+            uint32_t m_ClassCount = 1;
+
+            // m_Next[state * m_ClassCount + class], state 0 rejects and 1 is the start
+            std::vector<uint16_t> m_Next;
+            std::vector<LawsuitField> m_Accept;
+    };
+
+} // namespace SCPY
@@ -0,0 +1,155 @@
+#include "Whitespace.h"
+#include "Core/Simd.h"
+
+// std
+#include <cstdint>
+
+
+
+namespace SCPY
+{
+    namespace
+    {
+        // Handles one byte, p_Out is where the next byte goes
+        inline char* Step(char c, char* p_Out, const char* p_Begin)
+        {
+            if ((unsigned char)c < 0x20)
+                return p_Out;
+            if (c == ' ' && (p_Out == p_Begin || p_Out[-1] == ' '))
+                return p_Out;
+
+            *p_Out = c;
+            return p_Out + 1;
+        }
+
+        inline size_t TrimEnd(const char* p_Begin, char* p_Out)
+        {
+            if (p_Out != p_Begin && p_Out[-1] == ' ')
+                p_Out--;
+            return (size_t)(p_Out - p_Begin);
+        }
+
+    #ifdef SCPY_X86
+        // A block goes out untouched when it has no control character, no double space,
+        // and does not start with a space that would follow another one (or start the output).
+        // Blocks failing that are rare in running text and go through Step byte by byte.
+
+        SCPY_TARGET("sse2")
+        size_t NormalizeSSE2(const char* p_Input, size_t p_Size, char* p_Output)
+        {
+            const __m128i controlMax = _mm_set1_epi8(0x1F);
+            const __m128i space = _mm_set1_epi8(' ');
+
+            char* out = p_Output;
+            size_t i = 0;
+            for (; i + 16 <= p_Size; i += 16)
+            {
+                __m128i block = _mm_loadu_si128((const __m128i*)(p_Input + i));
+
+                __m128i controls = _mm_cmpeq_epi8(_mm_min_epu8(block, controlMax), block);
+                __m128i spaces = _mm_cmpeq_epi8(block, space);
+                __m128i doubles = _mm_and_si128(spaces, _mm_slli_si128(spaces, 1));
+
+                bool leadingSpace = p_Input[i] == ' ' && (out == p_Output || out[-1] == ' ');
+                if (_mm_movemask_epi8(_mm_or_si128(controls, doubles)) == 0 && !leadingSpace)
+                {
+                    _mm_storeu_si128((__m128i*)out, block);
+                    out += 16;
+                    continue;
+                }
+
+                for (size_t j = i; j < i + 16; j++)
+                    out = Step(p_Input[j], out, p_Output);
+            }
+
+            for (; i < p_Size; i++)
+                out = Step(p_Input[i], out, p_Output);
+
+            return TrimEnd(p_Output, out);
+        }
+
+        SCPY_TARGET("avx2")
+        size_t NormalizeAVX2(const char* p_Input, size_t p_Size, char* p_Output)
+        {
+            const __m256i controlMax = _mm256_set1_epi8(0x1F);
+            const __m256i space = _mm256_set1_epi8(' ');
+
+            char* out = p_Output;
+            size_t i = 0;
+            for (; i + 32 <= p_Size; i += 32)
+            {
+                __m256i block = _mm256_loadu_si256((const __m256i*)(p_Input + i));
+
+                __m256i controls = _mm256_cmpeq_epi8(_mm256_min_epu8(block, controlMax), block);
+                __m256i spaces = _mm256_cmpeq_epi8(block, space);
+
+                // shift the space mask up one byte across the two 128 bit lanes
+                __m256i previous = _mm256_alignr_epi8(spaces, _mm256_permute2x128_si256(spaces, spaces, 0x08), 15);
+                __m256i doubles = _mm256_and_si256(spaces, previous);
+
+                bool leadingSpace = p_Input[i] == ' ' && (out == p_Output || out[-1] == ' ');
+                if (_mm256_movemask_epi8(_mm256_or_si256(controls, doubles)) == 0 && !leadingSpace)
+                {
+                    _mm256_storeu_si256((__m256i*)out, block);
+                    out += 32;
+                    continue;
+                }
+
+                for (size_t j = i; j < i + 32; j++)
+                    out = Step(p_Input[j], out, p_Output);
+            }
+
+            for (; i < p_Size; i++)
+                out = Step(p_Input[i], out, p_Output);
+
+            return TrimEnd(p_Output, out);
+        }
+    #endif
+
+        using KernelFn = size_t(*)(const char*, size_t, char*);
+
+        struct Kernel
+        {
+            KernelFn Function;
+            const char* Name;
+        };
+
+        Kernel SelectKernel()
+        {
+        #ifdef SCPY_X86
+            if (HasAVX2())
+                return { NormalizeAVX2, "AVX2" };
+            return { NormalizeSSE2, "SSE2" };
+        #else
+            return { NormalizeWhitespaceScalar, "Scalar" };
+        #endif
+        }
+
+        const Kernel& GetKernel()
+        {
+            static const Kernel s_Kernel = SelectKernel();
+            return s_Kernel;
+        }
+
+    } // namespace
+
+    size_t NormalizeWhitespaceScalar(const char* p_Input, size_t p_Size, char* p_Output)
+    {
+        char* out = p_Output;
+        for (size_t i = 0; i < p_Size; i++)
+            out = Step(p_Input[i], out, p_Output);
+
+        return TrimEnd(p_Output, out);
+    }
+
+    size_t NormalizeWhitespace(const char* p_Input, size_t p_Size, char* p_Output)
+    {
+        return GetKernel().Function(p_Input, p_Size, p_Output);
+    }
+
+    const char* GetWhitespaceKernelName()
+    {
+        return GetKernel().Name;
+    }
+
+} // namespace SCPY
@@ -0,0 +1,27 @@
+#pragma once
+
+// std
+#include <cstddef>
+#include <string>
+
+
+
+namespace SCPY
+{
+    // Single pass text cleanup for extracted fields: drops C0 control characters (line breaks, tabs, NUL...),
+    // collapses runs of spaces into one and trims both ends. p_Output may be p_Input to work in place.
+    // Returns the size written, never more than p_Size.
+    size_t NormalizeWhitespace(const char* p_Input, size_t p_Size, char* p_Output);
+
+    inline void NormalizeWhitespace(std::string& p_Text)
+    {
+        p_Text.resize(NormalizeWhitespace(p_Text.data(), p_Text.size(), p_Text.data()));
+    }
+
+    // Portable reference, also what the vector kernels fall back to for blocks they cannot copy as is
+    size_t NormalizeWhitespaceScalar(const char* p_Input, size_t p_Size, char* p_Output);
+
+    // "AVX2", "SSE2" or "Scalar", whichever the dispatcher picked for this cpu
+    const char* GetWhitespaceKernelName();
+
+} // namespace SCPY
@@ -1,12 +1,15 @@
-#include "Core/Base.h"
-#include "Core/Search.h"
 #include "Core/Application.h"
+#include "CLI/Batch.h"
 
 
 
-int main()
+int main(int argc, char** argv)
 {
+    // any argument means a scripted run, which never opens the window
+    if (argc > 1)
+        return SCPY::RunBatch(argc, argv);
+
     auto app = new SCPY::Application();
     app->Run();
     delete app;
-}
\ No newline at end of file
+}